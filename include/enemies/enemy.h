@@ -36,6 +36,8 @@ protected:
 	Vec2 flee(const Vec2& target) const;
 	Vec2 pursuit(const GameObject& target, const float& predictionMultiplier = 1.0f) const;
 	Vec2 evade(const GameObject& target, const float& predictionMultiplier = 1.0f) const;
+	// Follows the flow field towards the player around terrain. Seeks target where there is none.
+	Vec2 followFlow(const GameObject& target) const;
 
 	void avoidTerrain(const float strength, const float avoidDist);
 
@@ -46,7 +48,7 @@ protected:
 
 	const CombatScene* combatScene;
 
-	std::function<void(Scene&)> debugRender() const override;
+	void debugRender(Scene& scene) const override;
 
 private:
 	const float moveSpeed;
@@ -35,6 +35,8 @@ private:
 	// Called at the appropriate time during the attack animation
 	void attack(Scene& scene);
 	void attackRangeCheck();
+	// Closer to the player than this the flow field is not followed.
+	constexpr static const float directRange = 200.0f;
 	constexpr static const float repositionTime = 1.0f;
 	float repositionTimer = repositionTime;
 };
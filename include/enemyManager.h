@@ -1,5 +1,8 @@
 #pragma once
 
+#include <functional>
+#include <optional>
+#include <random>
 #include <vector>
 
 #include "enemies/enemy.h"
@@ -31,19 +34,18 @@ class EnemySpawner {
 public:
 	EnemySpawner(EnemyManager& manager);
 
-	void update(Scene& scene, const float deltaTime);
+	// Picks a random spawn position, or nothing if there is no room to spawn.
+	using PositionSampler = std::function<std::optional<Vec2>(std::mt19937&)>;
 
-	void updateSpawnPositions(std::vector<Vec2>&& newSpawns);
+	void update(Scene& scene, const float deltaTime, const PositionSampler& samplePosition);
 
 private:
 	EnemyManager& manager;
 
-	std::vector<Vec2> spawnPositions;
-
 	float timer;
 	static constexpr float timeMin = 2;
 	static constexpr float timeMax = 5;
 
-	// Randomly chooses a position from spawnPositions and spawns an enemy there.
-	void spawn(Scene& scene);
+	// Spawns an enemy at a position from samplePosition, if there is one.
+	void spawn(Scene& scene, const PositionSampler& samplePosition);
 };
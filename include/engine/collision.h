@@ -83,6 +83,8 @@ public:
 	void collisionUpdate(Scene& scene);
 	void addCollision(const Collision::Event event);
 	virtual void checkCollisions(const Scene& scene) = 0;
+	// Moves the collider by offset, for when the world origin is moved.
+	virtual void shift(const Vec2& offset) = 0;
 
 	Collision::Types getCollisionType() const { return collisionType; }
 
@@ -123,6 +125,7 @@ public:
 	Collision::Circle circle;
 
 	void checkCollisions(const Scene& scene) override;
+	void shift(const Vec2& offset) override { circle.position += offset; }
 };
 
 class LineCollider : public Collider {
@@ -134,6 +137,11 @@ public:
 	Collision::Line line;
 
 	void checkCollisions(const Scene& scene) override;
+	void shift(const Vec2& offset) override {
+		line.position += offset;
+		line.start += offset;
+		line.end += offset;
+	}
 };
 
 class PointCollider : public Collider {
@@ -145,4 +153,5 @@ public:
 	Vec2 point;
 
 	void checkCollisions(const Scene& scene) override;
+	void shift(const Vec2& offset) override { point += offset; }
 };
@@ -1,24 +1,40 @@
 #pragma once
 
 #include <array>
+#include <chrono>
+#include <future>
 #include <memory>
 #include <random>
 #include <vector>
 
 #include "engine/gameObject.h"
+#include "engine/loadingProgress.h"
+#include "engine/renderBackend.h"
 #include "engine/renderManager.h"
 #include "engine/resourceManager.h"
+#include "engine/threadPool.h"
 #include "engine/vector2D.h"
 
 class Scene;
 
 class Game {
 public:
-	Game(const char* title, const int width, const int height);
+	/* @param backend What is drawn into. RenderBackend::Type::NONE needs no display, which makes
+	 * the Game usable in tests and headless benchmarks.
+	 */
+	Game(const char* title, const int width, const int height,
+	     const RenderBackend::Type backend = RenderBackend::Type::ACCELERATED);
 	~Game();
 
 	std::mt19937 randGen;
 
+	enum class RenderMode {
+		FULL_RESOLUTION = 0,  // Everything is drawn directly into the window
+		// The world is drawn into an offscreen target at native art resolution
+		// (window size / pixelSize) and upscaled once. UI stays at full resolution.
+		LOW_RESOLUTION,
+	};
+
 	// Game loop
 	void handleEvents();
 	void update();
@@ -31,16 +47,35 @@ public:
 
 	template <class T>
 	void addScene();
-
-	// SDL stuff
-	SDL_Window* getWindow() const { return window; }
-	SDL_Renderer* getRenderer() const { return renderer; }
+	/* Constructs scene T on a worker thread, and changes to it once it is done. The current scene
+	 * keeps running in the meantime, so the window stays responsive.
+	 * T is constructed with (Game&, LoadingProgress*) and must not make SDL calls there, those
+	 * belong in initialize, which is called on the main thread.
+	 */
+	template <class T>
+	void loadScene();
+	const LoadingProgress& getLoadingProgress() const { return loadingProgress; }
+	// @return If the scene started by loadScene is still being constructed.
+	bool isLoadingScene() const {
+		return pendingScene.valid() &&
+		       pendingScene.wait_for(std::chrono::seconds{0}) != std::future_status::ready;
+	}
+
+	// SDL stuff, null if the render backend has no window or renderer
+	SDL_Window* getWindow() const { return renderBackend->getWindow(); }
+	SDL_Renderer* getRenderer() const { return renderBackend->getRenderer(); }
+	const RenderBackend& getRenderBackend() const { return *renderBackend; }
 	constexpr static const int pixelSize = 3;
 
+	// Falls back to FULL_RESOLUTION if the renderer does not support render targets.
+	void setRenderMode(const RenderMode mode);
+	RenderMode getRenderMode() const { return renderMode; }
+
 	const Vec2& getWinDimensions() const { return winDimensions; }
 
 	RenderManager& getRenderManager() { return renderManager; }
 	ResourceManager& getResourceManager() { return resourceManager; }
+	ThreadPool& getThreadPool() { return threadPool; }
 
 	const std::array<bool, 256>& getInput() const { return input; }
 	// Button value true if button is being held
@@ -51,10 +86,13 @@ public:
 
 private:
 	bool isRunning;
-	SDL_Window* window;
-	SDL_Renderer* renderer;
+	std::unique_ptr<RenderBackend> renderBackend;
 	const Vec2 winDimensions;
 
+	RenderMode renderMode;
+	SDL_Texture* worldTarget;  // Native resolution target used by RenderMode::LOW_RESOLUTION
+	void renderWorld() const;
+
 	std::array<bool, 256> input;
 	std::array<bool, 32> mouseInput;
 	std::array<bool, 32> onMouseDown;
@@ -64,10 +102,17 @@ private:
 
 	std::vector<std::unique_ptr<Scene>> scenes;
 	uint16_t currentScene;
-	constexpr static const uint16_t sceneCount = 1;
+	constexpr static const uint16_t sceneCount = 2;
+
+	std::future<std::unique_ptr<Scene>> pendingScene;
+	LoadingProgress loadingProgress;
+	// Adds and changes to the scene loaded by loadScene if it is done.
+	void pollPendingScene();
 
 	RenderManager renderManager;
 
 	ResourceManager resourceManager;
 	ResourceManager initializeResourceManager() const;
+
+	ThreadPool threadPool;
 };
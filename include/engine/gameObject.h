@@ -8,6 +8,7 @@
 #include "SDL2/SDL_render.h"
 #include "engine/animationData.h"
 #include "engine/collision.h"
+#include "engine/textureAtlas.h"
 #include "engine/vector2D.h"
 
 // Use this inside protected section of child class to set its texture
@@ -18,6 +19,7 @@
 	}
 
 class Scene;
+class SpriteBatch;
 
 class GameObject {
 public:
@@ -29,7 +31,10 @@ public:
 	void initialize(const Scene& scene, const Vec2& startPos = {0, 0});
 	// Should be called after finishing velocity calculations
 	virtual void update(Scene& scene, const float deltaTime);
-	void render(SDL_Renderer* renderer) const;
+	// Adds the sprite to batch, which draws it like SDL_RenderCopyEx would.
+	void render(SpriteBatch& batch) const;
+	// Returns true if the object, including any rotation, can overlap the screen rectangle view.
+	bool isOnScreen(const SDL_Rect& view) const;
 
 	// Position and rotation
 	Vec2 getRenderPosition() const { return renderPosition; }
@@ -37,6 +42,8 @@ public:
 	Vec2 getPosition() const { return position; }
 	Vec2 getVelocity() const { return velocity; }
 	Vec2 getSize() const { return size; }
+	// Moves the object and its collider by offset, for when the world origin is moved.
+	void shiftPosition(const Vec2& offset);
 	// Returns the rotation as a direction vector
 	inline Vec2 getDirection() const {
 		float radians = (rotation - 90) * M_PI / 180;
@@ -92,10 +99,11 @@ protected:
 	SDL_RendererFlip flipType;
 	SDL_Rect srcRect, destRect;
 
-	virtual std::function<void(Scene&)> debugRender() const;
+	// Adds debug gizmos for the collider, velocity and render rect to the RenderManager
+	virtual void debugRender(Scene& scene) const;
 
 private:
-	SDL_Texture* texture;
+	TextureAtlas::Region region;  // Where the texture sheet is in the atlas
 
 	const Vec2 baseSize;
 	Vec2 size;
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+
+// Progress of work done on another thread. Safe to read while it is being written.
+class LoadingProgress {
+public:
+	// Starts counting towards total, forgetting earlier progress.
+	void start(const std::size_t total) {
+		done = 0;
+		this->total = total;
+	}
+	void advance() { done++; }
+
+	// @return Fraction of the work that is done, between 0 and 1.
+	float get() const {
+		const std::size_t count = total;
+		return count == 0 ? 0.0f : std::min(1.0f, static_cast<float>(done) / count);
+	}
+
+private:
+	std::atomic<std::size_t> done{0};
+	std::atomic<std::size_t> total{0};
+};
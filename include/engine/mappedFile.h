@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Memory mapping of a whole file.
+class MappedFile {
+public:
+	// Read only mapping of an existing file. Check isOpen to see if the mapping succeeded.
+	MappedFile(const std::string& path);
+	/* Writable mapping of the file at path, which is created or truncated to size bytes.
+	 * Changes are written back to the file by the operating system.
+	 *
+	 * @param size Must be larger than zero.
+	 */
+	MappedFile(const std::string& path, const std::size_t size);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	MappedFile(MappedFile&& other) noexcept;
+	MappedFile& operator=(MappedFile&& other) noexcept;
+
+	bool isOpen() const { return data != nullptr; }
+	bool isWritable() const { return writable; }
+	const std::byte* getData() const { return data; }
+	// @return nullptr if the mapping is read only.
+	std::byte* getWritableData() { return writable ? data : nullptr; }
+	std::size_t getSize() const { return size; }
+
+	/* Changes the size of a writable file and maps it again. Pointers into the old mapping are
+	 * invalidated, the contents are kept.
+	 *
+	 * @return False if the mapping is read only or the file could not be resized, the mapping
+	 *		   is closed in the second case.
+	 */
+	bool resize(const std::size_t newSize);
+
+private:
+	std::byte* data;
+	std::size_t size;
+	bool writable;
+
+#ifdef _WIN32
+	void* fileHandle;
+	void* mappingHandle;
+#else
+	int fd;  // Only kept open for writable mappings
+#endif
+
+	// Maps size bytes of the open file.
+	bool map();
+	void unmap();
+	void close();
+};
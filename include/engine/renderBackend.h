@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+
+#include "SDL2/SDL_render.h"
+#include "SDL2/SDL_surface.h"
+#include "SDL2/SDL_video.h"
+
+/* Owns what the game draws into. Everything is still drawn with the SDL_Renderer it gives out,
+ * backends only differ in where that renderer draws to, or if there is one at all.
+ */
+class RenderBackend {
+public:
+	enum class Type {
+		ACCELERATED = 0,  // Window with a hardware renderer
+		SOFTWARE,         // No window, draws into a surface on the CPU
+		NONE,             // No window or renderer, frames are only counted
+	};
+
+	struct FrameStats {
+		std::size_t frames = 0;
+		std::size_t commands = 0;  // Summed over all frames, RenderManager commands
+	};
+
+	static std::unique_ptr<RenderBackend> create(const Type type);
+	virtual ~RenderBackend() = default;
+
+	// @return False if it could not be created, SDL_GetError tells why.
+	virtual bool initialize(const char* title, const int width, const int height) = 0;
+	virtual void destroy() = 0;
+
+	// Shows what has been drawn this frame, if anything is shown.
+	void endFrame(const std::size_t commandCount);
+
+	// Null when the backend has no window or renderer
+	SDL_Window* getWindow() const { return window; }
+	SDL_Renderer* getRenderer() const { return renderer; }
+	const FrameStats& getStats() const { return stats; }
+
+protected:
+	SDL_Window* window = nullptr;
+	SDL_Renderer* renderer = nullptr;
+
+	virtual void present() {}
+
+private:
+	FrameStats stats;
+};
+
+class AcceleratedBackend : public RenderBackend {
+public:
+	bool initialize(const char* title, const int width, const int height) override;
+	void destroy() override;
+
+protected:
+	void present() override;
+};
+
+class SoftwareBackend : public RenderBackend {
+public:
+	bool initialize(const char* title, const int width, const int height) override;
+	void destroy() override;
+
+	// Holds the last drawn frame
+	SDL_Surface* getSurface() const { return surface; }
+
+private:
+	SDL_Surface* surface = nullptr;
+};
+
+class NullBackend : public RenderBackend {
+public:
+	bool initialize(const char* title, const int width, const int height) override;
+	void destroy() override {}
+};
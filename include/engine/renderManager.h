@@ -1,27 +1,103 @@
 #pragma once
 
-#include <functional>
+#include <cstdint>
+#include <type_traits>
 #include <vector>
 
+#include "SDL2/SDL_render.h"
+#include "engine/spriteBatch.h"
+
 class GameObject;
-class Scene;
 
+namespace UI {
+class Widget;
+}
+
+/* One drawing operation, stored by value so a frame of them is a single array.
+ * Which member of the union is used depends on type.
+ */
+struct RenderCommand {
+	enum class Type : std::uint8_t { FILL_RECT, RECT, LINE, CIRCLE, SPRITE, WIDGET };
+
+	struct Line {
+		SDL_FPoint start, end;
+	};
+	struct Circle {
+		SDL_FPoint center;
+		float radius;
+	};
+	// Same arguments as SDL_RenderCopyEx, the texture is kept outside the union to sort on it
+	struct Sprite {
+		SDL_Rect src, dest;
+		double angle;
+		SDL_Point center;
+		SDL_RendererFlip flip;
+	};
+	// The widget is rendered unless its parent has been marked for deletion
+	struct Widget {
+		const UI::Widget* widget;
+		const GameObject* parent;
+	};
+
+	Type type;
+	std::uint8_t layer;
+	std::uint32_t sequence;  // Order it was added in, keeps the sorting stable
+	SDL_Texture* texture;    // Only used by sprites, to batch them
+	SDL_Color color;
+	union {
+		SDL_FRect rect;  // FILL_RECT and RECT
+		Line line;
+		Circle circle;
+		Sprite sprite;
+		Widget widget;
+	};
+};
+static_assert(std::is_trivially_copyable_v<RenderCommand>);
+
+/* Overlays drawn on top of the scene, like healthbars and debug gizmos.
+ * Commands are added during the update, in screen coordinates, and rendered once that frame.
+ * They are kept in one array that keeps its memory between frames, so after the first frames
+ * adding and sorting commands does not allocate.
+ */
 class RenderManager {
 public:
-	RenderManager();
+	// Drawn in increasing order, later commands on the same layer are drawn on top
+	static constexpr std::uint8_t debugLayer = 0;
+	static constexpr std::uint8_t uiLayer = 1;
 
-	// Adds a rendering call to the list that will be rendered.
-	// Also takes a GameObject pointer to the parent of the Widget
-	// to check for possible deletion (fixing #29).
-	void addRenderCall(std::function<void(Scene&)> func, const GameObject* parent);
+	void addFillRect(const SDL_FRect& rect, const SDL_Color& color, const std::uint8_t layer);
+	void addRect(const SDL_FRect& rect, const SDL_Color& color, const std::uint8_t layer);
+	void addLine(const SDL_FPoint& start, const SDL_FPoint& end, const SDL_Color& color,
+	             const std::uint8_t layer);
+	void addCircle(const SDL_FPoint& center, const float radius, const SDL_Color& color,
+	               const std::uint8_t layer);
+	/* Same arguments as SDL_RenderCopyEx. Sprites added after each other with the same texture
+	 * are drawn in one call, which sprites from the texture atlas always are.
+	 */
+	void addSprite(SDL_Texture* texture, const SDL_Rect& src, const SDL_Rect& dest,
+	               const double angle, const SDL_Point& center, const SDL_RendererFlip flip,
+	               const std::uint8_t layer);
+	/* @param widget Must stay alive until it is rendered, unless parent is marked for deletion.
+	 * @param parent GameObject owning the widget, which is checked for deletion (fixing #29).
+	 */
+	void addWidget(const UI::Widget& widget, const GameObject* parent, const std::uint8_t layer);
 
-	// Resets the renderCallCnt to zero
-	void resetCallCnt();
+	// Removes the commands of the previous frame. Call before anything is added.
+	void clear();
+	/* Drops widgets whose parent is marked for deletion and sorts the rest by layer.
+	 * Call after everything is added, before the marked GameObjects are deleted.
+	 */
 	void update();
-	void render(Scene& scene) const;
+	void render(SDL_Renderer* renderer) const;
+
+	const std::vector<RenderCommand>& getCommands() const { return commands; }
 
 private:
-	// Render function, parent
-	std::vector<std::pair<std::function<void(Scene&)>, const GameObject*>> renderCalls;
-	int renderCallCnt;  // Keep track of amount of calls to avoid clearing vector every frame
+	std::vector<RenderCommand> commands;
+	// Only used while rendering, kept to reuse the memory
+	mutable SpriteBatch spriteBatch;
+	mutable std::vector<SDL_FRect> fillRects;
+
+	RenderCommand& add(const RenderCommand::Type type, const SDL_Color& color,
+	                   const std::uint8_t layer);
 };
@@ -1,9 +1,9 @@
 #pragma once
 
 #include <string>
-#include <unordered_map>
+#include <string_view>
 
-#include "SDL2/SDL_render.h"
+#include "engine/textureAtlas.h"
 
 class Game;
 
@@ -11,10 +11,15 @@ class ResourceManager {
 public:
 	ResourceManager(std::string&& assetsPath);
 
-	SDL_Texture* loadTexture(const std::string_view filename, Game& game);
+	// Packs every image in the assets folder into the atlas. Call once the renderer exists.
+	void loadAtlas(Game& game);
+	// @return Where the image is in the atlas, an empty region if it could not be loaded.
+	const TextureAtlas::Region& getRegion(const std::string_view filename, Game& game);
 	void destroyTextures();
 
+	const TextureAtlas& getAtlas() const { return atlas; }
+
 private:
 	const std::string assetsPath;
-	std::unordered_map<std::string_view, SDL_Texture*> loadedTextures;
+	TextureAtlas atlas;
 };
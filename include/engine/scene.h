@@ -7,6 +7,7 @@
 #include "engine/Tree2D.h"
 #include "engine/camera.h"
 #include "engine/gameObject.h"
+#include "engine/spriteBatch.h"
 #include "player.h"
 
 class Game;
@@ -62,6 +63,11 @@ public:
 	Game& getGame() const { return game; }
 	const Camera& getCam() const { return cam; }
 
+	/* Moves every GameObject and the camera by offset, and rebuilds the object tree. Used to move
+	 * the world origin, so positions stay small and precise far away from where the world starts.
+	 */
+	void shiftOrigin(const Vec2& offset);
+
 	void reset();
 
 protected:
@@ -79,4 +85,7 @@ private:
 	GameObjectVector gameObjects;
 	Tree2D objectTree;
 	void updateObjectTree();
+
+	// Draws the GameObjects. Kept between frames so its buffers are reused.
+	mutable SpriteBatch spriteBatch;
 };
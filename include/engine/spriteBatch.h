@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+#include "SDL2/SDL_render.h"
+
+/* Collects sprites during a frame and draws all sprites of a texture with a single
+ * SDL_RenderGeometry call, so the amount of draw calls depends on the amount of textures instead
+ * of the amount of sprites. The rotated quads are calculated on the CPU.
+ * Sprites with the same texture keep their order, but a texture is drawn in one go, at the
+ * position it was first added at. Sprites of different textures that overlap can therefore be
+ * drawn in another order than they were added in.
+ */
+class SpriteBatch {
+public:
+	// Same arguments as SDL_RenderCopyEx. The sprite is skipped if texture is null.
+	void add(SDL_Texture* texture, const SDL_Rect& src, const SDL_Rect& dest, const double angle,
+	         const SDL_Point& center, const SDL_RendererFlip flip);
+	// Draws the sprites added since the last call, one draw call per texture.
+	void render(SDL_Renderer* renderer);
+
+	std::size_t getBatchCount() const { return batchCount; }
+
+	/* Corners of a sprite drawn like SDL_RenderCopyEx would, in the order top left, top right,
+	 * bottom right and bottom left of the unrotated destination.
+	 *
+	 * @param textureWidth, textureHeight Size of the whole texture, for the texture coordinates.
+	 * @param center Point dest is rotated around, relative to its top left corner.
+	 * @param angle Clockwise rotation in degrees.
+	 */
+	static std::array<SDL_Vertex, 4> makeQuad(const int textureWidth, const int textureHeight,
+	                                          const SDL_Rect& src, const SDL_Rect& dest,
+	                                          const double angle, const SDL_Point& center,
+	                                          const SDL_RendererFlip flip,
+	                                          const SDL_Color& color);
+
+private:
+	struct Batch {
+		SDL_Texture* texture;
+		int width, height;
+		// SDL_RenderGeometry ignores the color and alpha mod of the texture, so they are put in
+		// the vertices instead.
+		SDL_Color color;
+		std::vector<SDL_Vertex> vertices;
+		std::vector<int> indices;
+	};
+	// Only the first batchCount are used this frame, the rest keep their memory for later frames
+	std::vector<Batch> batches;
+	std::size_t batchCount = 0;
+
+	Batch& getBatch(SDL_Texture* texture);
+};
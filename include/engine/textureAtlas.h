@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "SDL2/SDL_render.h"
+#include "SDL2/SDL_surface.h"
+
+/* Images packed together into a few large textures, called pages, so sprites of different images
+ * can be drawn in the same batch.
+ */
+class TextureAtlas {
+public:
+	// Where an image is in the atlas
+	struct Region {
+		SDL_Texture* texture = nullptr;  // Page the image is on, null without a renderer
+		SDL_Rect rect{};                 // Position and size of the image on the page
+	};
+
+	struct Placement {
+		std::size_t page;
+		SDL_Rect rect;
+	};
+	/* Places rectangles of the given sizes on as few pages as possible, in rows sorted by height.
+	 * Placed rectangles are padding pixels apart. Rectangles larger than maxSize get a page
+	 * of their own.
+	 *
+	 * @param pageSizes Size each page needs to hold what is placed on it.
+	 * @return Placement of every size, in the same order as sizes.
+	 */
+	static std::vector<Placement> pack(const std::vector<SDL_Point>& sizes, const int maxSize,
+	                                   const int padding, std::vector<SDL_Point>& pageSizes);
+
+	/* Copies the images into new pages and creates their textures.
+	 * The surfaces are not freed. If renderer is null only the regions are calculated.
+	 *
+	 * @param maxSize Largest width and height of a page.
+	 */
+	void build(SDL_Renderer* renderer,
+	           const std::vector<std::pair<std::string, SDL_Surface*>>& images, const int maxSize);
+	void destroy();
+
+	// @return Nullptr if no image with the name was built into the atlas.
+	const Region* find(const std::string_view name) const;
+	std::size_t getPageCount() const { return pageCount; }
+
+private:
+	std::vector<SDL_Texture*> pages;
+	std::size_t pageCount = 0;
+	std::map<std::string, Region, std::less<>> regions;
+};
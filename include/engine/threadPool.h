@@ -0,0 +1,56 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Fixed size pool of worker threads.
+class ThreadPool {
+public:
+	// @param threadCount Amount of worker threads. Zero uses the hardware concurrency.
+	ThreadPool(const std::size_t threadCount = 0);
+	~ThreadPool();
+
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	// Queues task to be run on a worker thread.
+	// @return Future holding the result of task.
+	template <class F>
+	std::future<std::invoke_result_t<F>> submit(F&& task) {
+		auto packaged =
+		    std::make_shared<std::packaged_task<std::invoke_result_t<F>()>>(std::forward<F>(task));
+		std::future<std::invoke_result_t<F>> result = packaged->get_future();
+		{
+			std::lock_guard lock{mutex};
+			tasks.emplace([packaged] { (*packaged)(); });
+		}
+		condition.notify_one();
+		return result;
+	}
+
+	/* Calls func(i) for every i in [0, count). The calls are split between the workers and the
+	 * calling thread, and this returns when all of them have finished.
+	 * Safe to call from inside a task running on this pool.
+	 */
+	void parallelFor(const std::size_t count, const std::function<void(std::size_t)>& func);
+
+	std::size_t getThreadCount() const { return workers.size(); }
+
+private:
+	std::vector<std::thread> workers;
+
+	std::queue<std::function<void()>> tasks;
+	std::mutex mutex;
+	std::condition_variable condition;
+	bool stopping;
+
+	void workerLoop();
+};
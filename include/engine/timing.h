@@ -0,0 +1,38 @@
+#pragma once
+
+#include <chrono>
+#include <utility>
+
+namespace Timing {
+using Clock = std::chrono::steady_clock;
+
+// @return Seconds since start.
+inline double secondsSince(const Clock::time_point start) {
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Adds the seconds it existed for to total, if total is not null.
+class ScopedTimer {
+public:
+	ScopedTimer(double* total) : total{total}, start{Clock::now()} {}
+	~ScopedTimer() {
+		if (total) *total += secondsSince(start);
+	}
+
+private:
+	double* const total;
+	const Clock::time_point start;
+};
+
+// @return Result of func, after adding the seconds it took to total if it is not null.
+template <class F>
+decltype(auto) timed(double* total, F&& func) {
+	const ScopedTimer timer{total};
+	return func();
+}
+
+template <class F>
+decltype(auto) timed(double& total, F&& func) {
+	return timed(&total, std::forward<F>(func));
+}
+}  // namespace Timing
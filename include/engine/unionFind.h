@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+// Disjoint sets of the elements [0, size), joined by unite.
+class UnionFind {
+public:
+	UnionFind(const std::uint32_t size = 0) { add(size); }
+
+	// Adds count new elements, each in its own set.
+	void add(const std::uint32_t count) {
+		const std::uint32_t start = parent.size();
+		parent.resize(start + count);
+		std::iota(parent.begin() + start, parent.end(), start);
+		rank.resize(parent.size(), 0);
+	}
+
+	// @return The element representing the set of element.
+	std::uint32_t find(std::uint32_t element) {
+		while (parent[element] != element) {
+			parent[element] = parent[parent[element]];  // Halve the path while walking it
+			element = parent[element];
+		}
+		return element;
+	}
+
+	void unite(std::uint32_t a, std::uint32_t b) {
+		a = find(a);
+		b = find(b);
+		if (a == b) return;
+		if (rank[a] < rank[b]) std::swap(a, b);
+		parent[b] = a;
+		if (rank[a] == rank[b]) rank[a]++;
+	}
+
+	std::uint32_t size() const { return parent.size(); }
+
+private:
+	std::vector<std::uint32_t> parent;
+	std::vector<std::uint8_t> rank;
+};
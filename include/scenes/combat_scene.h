@@ -1,20 +1,44 @@
 #pragma once
 
+#include <cstddef>
+
 #include "enemyManager.h"
 #include "engine/scene.h"
 #include "terrain/chunkManager.h"
 
+class LoadingProgress;
 class Player;
+class TerrainGenerator;
 
 class CombatScene : public Scene {
 public:
-	CombatScene(Game& game_);
+	/* Generates the chunks around the start, which is safe to do on a worker thread. The player
+	 * is spawned in initialize.
+	 *
+	 * @param progress Reports how many of the starting chunks are done if not null.
+	 */
+	CombatScene(Game& game_, LoadingProgress* progress = nullptr);
+
+	void initialize() override;
 
 	void update(const float deltaTime) override;
 	void render(SDL_Renderer* renderer) const override;
 
 	const EnemyManager& getEnemyManager() const { return enemyManager; }
 	const ChunkManager& getChunkManager() const { return chunkManager; }
+	// Only valid after initialize.
+	const Player& getPlayer() const { return *player; }
+
+	// Chunks are generated as the player gets close to them, so the size of the world does not
+	// affect startup time.
+	static constexpr std::size_t worldChunksX = 2000;
+	static constexpr std::size_t worldChunksY = 2000;
+	static constexpr std::size_t chunkSize = 100;
+	static constexpr std::size_t shapeSize = 10;
+	// Chunks from a world baked with the bake_world tool are loaded from this file if it exists.
+	static constexpr const char* bakePath = "world.bake";
+
+	static void setGeneratorParameters(TerrainGenerator& gen);
 
 private:
 	EnemyManager enemyManager;
@@ -23,7 +47,5 @@ private:
 	ChunkManager generateTerrain();
 	const Player& spawnPlayer();
 
-public:
-	// Player must be initialized after chunkManager
-	const Player& player;
+	const Player* player;
 };
@@ -0,0 +1,18 @@
+#pragma once
+
+#include "engine/UI/background.h"
+#include "engine/UI/slider.h"
+#include "engine/scene.h"
+
+// Shows a progress bar while another scene is loaded in the background, see Game::loadScene.
+class LoadingScene : public Scene {
+public:
+	LoadingScene(Game& game_);
+
+	void update(const float deltaTime) override;
+	void render(SDL_Renderer* renderer) const override;
+
+private:
+	UI::Background progressBG;
+	UI::Slider* progressSlider;  // Owned by progressBG
+};
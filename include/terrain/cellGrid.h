@@ -0,0 +1,36 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+#include "terrain/terrain.h"
+
+// Terrain cells stored row by row in one contiguous buffer.
+struct CellGrid {
+	std::size_t xSize;
+	std::size_t ySize;
+	std::vector<unsigned char> cells;
+
+	CellGrid(const std::size_t xSize, const std::size_t ySize)
+	    : xSize{xSize}, ySize{ySize}, cells(xSize * ySize) {}
+	CellGrid(const Terrain& terrain) : CellGrid{terrain.getXSize(), terrain.getYSize()} {
+		for (std::size_t y = 0; y < ySize; y++)
+			std::copy(terrain.map[y].begin(), terrain.map[y].end(), row(y));
+	}
+
+	unsigned char& at(const std::size_t x, const std::size_t y) { return cells[y * xSize + x]; }
+	unsigned char at(const std::size_t x, const std::size_t y) const {
+		return cells[y * xSize + x];
+	}
+
+	unsigned char* row(const std::size_t y) { return cells.data() + y * xSize; }
+	const unsigned char* row(const std::size_t y) const { return cells.data() + y * xSize; }
+
+	Terrain toTerrain() const {
+		Terrain terrain{xSize, ySize};
+		for (std::size_t y = 0; y < ySize; y++)
+			std::copy(row(y), row(y) + xSize, terrain.map[y].begin());
+		return terrain;
+	}
+};
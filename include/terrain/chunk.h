@@ -2,11 +2,17 @@
 
 #include <array>
 #include <cstddef>
+#include <cstdint>
+#include <future>
 #include <map>
+#include <memory>
 #include <optional>
+#include <span>
 
 #include "SDL2/SDL_rect.h"
 #include "enemyManager.h"
+#include "terrain/regionLabels.h"
+#include "terrain/spawnMap.h"
 #include "terrain/terrain.h"
 #include "terrain/terrainCollider.h"
 
@@ -14,13 +20,50 @@ class Scene;
 struct Vec2;
 struct SDL_Renderer;
 class Camera;
-class TerrainChange;
+struct TerrainChange;
+struct TerrainSpan;
 class ChunkManager;
 
 class Chunk {
 public:
-	Chunk(std::vector<std::vector<unsigned char>>&& map, const std::size_t originX,
-	      const std::size_t originY, ChunkManager& manager, EnemyManager& enemyManager);
+	// Collider line between two cell corners, in cells relative to the chunk.
+	struct Segment {
+		std::uint16_t startX, startY;
+		std::uint16_t endX, endY;
+	};
+	// Cell relative to the chunk with room to spawn around it.
+	struct SpawnCell {
+		std::uint16_t x, y;
+	};
+	// Uniform chunks skip the per cell work, they render as one rectangle and share their
+	// segments and spawn cells with all chunks of the same size.
+	enum class Fill {
+		EMPTY,
+		SOLID,
+		MIXED,
+	};
+
+	// Seconds spent on each part of building chunks.
+	struct BuildTimings {
+		double colliders = 0;
+		double spawns = 0;
+		double render = 0;
+
+		BuildTimings& operator+=(const BuildTimings& other);
+	};
+
+	/* Only reads the manager, so chunks can be constructed on different threads at the same time.
+	 *
+	 * @param timings Time spent building the chunk is added to this if it is not null.
+	 */
+	Chunk(std::vector<std::vector<unsigned char>>&& map, const float originX, const float originY,
+	      ChunkManager& manager, EnemyManager& enemyManager,
+	      BuildTimings* timings = nullptr);
+	// Uses already extracted segments, for example from a WorldBake, instead of finding them in
+	// map.
+	Chunk(std::vector<std::vector<unsigned char>>&& map, const float originX, const float originY,
+	      ChunkManager& manager, EnemyManager& enemyManager,
+	      const std::span<const Segment> segments, BuildTimings* timings = nullptr);
 
 	// Delete copy
 	Chunk(const Chunk&) = delete;
@@ -35,60 +78,177 @@ public:
 	};
 	States state;
 
+	/* How much of the chunk is kept in memory. Chunks away from the player only keep their
+	 * terrain, the colliders, render cache and spawn positions are built again when needed.
+	 */
+	enum class Residency {
+		COMPACT,  // Only the terrain
+		LOADING,  // Only the terrain, a worker is building the rest
+		FULL,
+	};
+	Residency getResidency() const { return residency; }
+	// Drops the colliders, render cache and spawn positions.
+	void makeCompact();
+	// Starts building what a compact chunk dropped on a worker thread, see finishRebuild.
+	void prefetch();
+	// Builds what a compact chunk dropped, or waits for the prefetch to finish.
+	void makeResident();
+
 	/* Sets the cell at position (x, y) to value.
 	 * x and y position is relative to this chunk.
+	 * The colliders and render cache are rebuilt in the background, see startRebuild.
 	 */
 	void changeTerrain(const TerrainChange& change);
-	void changeTerrainMultiple(const std::vector<TerrainChange>& changes);
+	/* Sets the cells of every span, in order. Safe to call for different chunks on different
+	 * threads at the same time.
+	 */
+	void changeTerrainSpans(const std::span<const TerrainSpan> spans);
+
+	/* Starts rebuilding the colliders and render cache on a worker thread, from a snapshot of the
+	 * current terrain. The current ones stay in use until finishRebuild swaps in the result.
+	 * If a rebuild is already running, a new one is started when that has finished.
+	 * Compact chunks are not rebuilt, they are built from the latest terrain when needed.
+	 */
+	void startRebuild();
+	/* Swaps in the result of a finished rebuild. Should be called at a frame boundary, when
+	 * nothing is referencing the old colliders.
+	 *
+	 * @return True if a result was swapped in.
+	 */
+	bool finishRebuild();
+	bool isRebuilding() const { return pendingBuild.valid(); }
 
 	void update(Scene& scene, const float deltaTime);
 	void collisionUpdate(Scene& scene);
 
-	void render(SDL_Renderer* renderer, const Camera& cam) const;
+	/* Renders the terrain cells that are inside the view.
+	 *
+	 * @param viewSize Size of the visible area in pixels, starting at the camera position.
+	 */
+	void render(SDL_Renderer* renderer, const Camera& cam, const Vec2& viewSize) const;
+	// Does nothing for compact chunks, as do updateColliders and updateSpawnPositions.
 	void updateRender(const int pixelSize);
 
 	void updateColliders();
 	std::size_t getColliderCount() const { return colliders.size(); }
 
+	// Builds the spawn map the enemy spawner samples from. Edits keep it up to date after that.
 	void updateSpawnPositions();
+	const SpawnMap& getSpawnMap() const { return spawnMap; }
+	// @return A random position where an enemy has room to spawn, if there is one.
+	std::optional<Vec2> sampleSpawnPosition(std::mt19937& randGen) const;
+	/* Finds spawn positions that do not overlap each other. Slower than sampling the spawn map,
+	 * for when a few spread out positions are needed.
+	 */
 	std::vector<Vec2> findSpawnPositions() const;
 
+	Fill getFill() const { return findFill(rowFilled, terrain->getXSize()); }
+
+	// @return Amount of filled cells in every row of terrain.
+	static std::vector<std::uint16_t> countRows(const Terrain& terrain);
+	// @param rowFilled Amount of filled cells in every row, see countRows.
+	static Fill findFill(const std::span<const std::uint16_t> rowFilled, const std::size_t xSize);
+
+	/* Finds the collider segments of terrain, with straight lines merged. Only reads terrain.
+	 * @param fill Fill of terrain. Uniform terrain is not scanned.
+	 */
+	static std::vector<Segment> findSegments(const Terrain& terrain, const Fill fill);
+	static std::vector<Segment> findSegments(const Terrain& terrain) {
+		return findSegments(terrain, findFill(countRows(terrain), terrain.getXSize()));
+	}
+	// Finds the cells with room for an enemy to spawn. Only reads terrain.
+	static std::vector<SpawnCell> findSpawnCells(const Terrain& terrain, const Fill fill);
+	static std::vector<SpawnCell> findSpawnCells(const Terrain& terrain) {
+		return findSpawnCells(terrain, findFill(countRows(terrain), terrain.getXSize()));
+	}
+
 	ChunkManager& getManager() const { return manager; }
-	const Terrain& getTerrain() const { return terrain; }
+	const Terrain& getTerrain() const { return *terrain; }
+	// Kept up to date by the changes, also for compact chunks.
+	const RegionLabels& getRegions() const { return regions; }
+	// Position of the top left corner relative to the world origin, in pixels.
+	float getOriginX() const { return originX; }
+	float getOriginY() const { return originY; }
+	/* Moves the chunk, its colliders and its render cache by offset, see
+	 * ChunkManager::recenterOrigin. Builds still running are moved when they are swapped in.
+	 */
+	void shiftOrigin(const Vec2& offset);
 
 private:
 	ChunkManager& manager;
 
-	Terrain terrain;
-	const std::size_t originX;
-	const std::size_t originY;
+	// Shared with rebuilds in progress. Copied before writing if a rebuild still uses it.
+	std::shared_ptr<Terrain> terrain;
+	float originX;
+	float originY;
+	// Amount of filled cells in every row of terrain, kept up to date by the changes
+	std::vector<std::uint16_t> rowFilled;
+	RegionLabels regions;
 
+	Residency residency;
+	// Empty for uniform chunks, see renderRowFilled.
 	std::vector<std::vector<SDL_Rect>> renderRects;
+	// rowFilled of the terrain renderRects was built from.
+	std::vector<std::uint16_t> renderRowFilled;
 	std::vector<TerrainCollider> colliders;
 
+	// Colliders and render cache built from one version of the terrain.
+	struct Build {
+		std::vector<TerrainCollider> colliders;
+		std::vector<std::vector<SDL_Rect>> renderRects;
+		std::vector<std::uint16_t> renderRowFilled;
+		// Only built when building a compact chunk
+		std::optional<SpawnMap> spawnMap;
+		// Origin the colliders and render cache were built at
+		float originX, originY;
+	};
+	std::future<Build> pendingBuild;
+	// The terrain was changed again after the pending build was started.
+	bool rebuildQueued;
+	void startBuild(const bool findSpawns);
+	// Moves the colliders and render cache by offset.
+	void shiftCaches(const Vec2& offset);
+
+	// @return The terrain, copied first if a rebuild is reading it.
+	Terrain& getWritableTerrain();
+
+	/* The builders only read their arguments, so they can run on worker threads.
+	 *
+	 * @param owner Chunk the colliders will belong to. Only stored, never accessed.
+	 */
+	static std::vector<TerrainCollider> buildColliders(const std::span<const Segment> segments,
+	                                                   const float originX,
+	                                                   const float originY, const int pixelSize,
+	                                                   Chunk& owner);
+	// Rows that are empty or completely filled are left empty, they are rendered from
+	// rowFilled.
+	static std::vector<std::vector<SDL_Rect>> buildRenderRects(
+	    const Terrain& terrain, const std::span<const std::uint16_t> rowFilled,
+	    const float originX, const float originY, const int pixelSize);
+
+	// Scanning versions of findSegments and findSpawnCells, for any fill.
+	static std::vector<Segment> scanSegments(const Terrain& terrain);
+	static std::vector<SpawnCell> scanSpawnCells(const Terrain& terrain);
+
 	/* Tries to extend an existing collider that ends at start to ending at end.
 	 *
 	 * @param start Start position of new collider, used to check against existing ends.
 	 * @param end End position of new collider, existing collider is extended to this.
 	 * @param currentColliders Map of existing colliders. Key: end, Value: start.
-	 * @param scene The scene to create the colliders in.
-	 */
-	void tryExtendCollider(const std::pair<int, int>& start, const std::pair<int, int>& end,
-	                       std::map<std::pair<int, int>, std::pair<int, int>>& currentColliders);
-	/* Creates a TerrainCollider at the middle point between start and end,
-	 * with a line collider from start to end.
-	 *
-	 * @param start Start position of LineCollider.
-	 * @param end End position of LineCollider.
-	 * @param scene The scene to create the collider in.
+	 * @param segments Where finished colliders are added.
 	 */
-	void createCollider(Vec2&& start, Vec2&& end);
+	static void tryExtendCollider(
+	    const std::pair<int, int>& start, const std::pair<int, int>& end,
+	    std::map<std::pair<int, int>, std::pair<int, int>>& currentColliders,
+	    std::vector<Segment>& segments);
 
 	EnemySpawner enemySpawner;
-	static constexpr int minSpawnSpace = 15;
-	static std::array<int, minSpawnSpace> spawnCircleY;
+	SpawnMap spawnMap;
+	static constexpr int minSpawnSpace = SpawnMap::minSpace;
+	// Spawn positions tried before giving up on spawning for now.
+	static constexpr int spawnTries = 4;
 	// @return Position where there is terrain blocking. Has no value if none were found.
-	std::optional<std::pair<std::size_t, std::size_t>> findObstruction(const std::size_t x,
-	                                                                   const std::size_t y,
-	                                                                   const Terrain& used) const;
+	static std::optional<std::pair<std::size_t, std::size_t>> findObstruction(
+	    const std::size_t x, const std::size_t y, const Terrain& used);
+	std::vector<Vec2> toSpawnPositions(const std::span<const SpawnCell> cells) const;
 };
@@ -1,29 +1,75 @@
 #pragma once
 
-#include <queue>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <iosfwd>
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
 #include <vector>
 
 #include "SDL2/SDL_pixels.h"
 #include "engine/Tree2D.h"
 #include "engine/game.h"
 #include "terrain/chunk.h"
+#include "terrain/distanceField.h"
+#include "terrain/flowField.h"
 #include "terrain/terrain.h"
+#include "terrain/terrainGenerator.h"
+#include "terrain/terrainShapes.h"
+#include "terrain/terrainStore.h"
+#include "terrain/worldBake.h"
 
 struct SDL_Renderer;
+class LoadingProgress;
 class Scene;
 class TerrainCollider;
 class Camera;
 
 struct TerrainChange {
-	const std::size_t x;
-	const std::size_t y;
-	const unsigned char value;
+	std::size_t x;
+	std::size_t y;
+	unsigned char value;
 };
 
 class ChunkManager {
 public:
+	// Closest terrain to a position, see getWallDistance.
+	struct WallDistance {
+		float distance;  // In pixels
+		Vec2 direction;  // Away from the terrain
+	};
+
+	// Seconds spent loading chunks. The parts are summed over all threads, wall is the time the
+	// loads took.
+	struct LoadTimings {
+		double generate = 0;  // Generating, decoding or reading stored terrain
+		double split = 0;     // Copying chunks out of a whole terrain
+		Chunk::BuildTimings build;
+		double wall = 0;
+		std::size_t chunks = 0;
+
+		LoadTimings& operator+=(const LoadTimings& other);
+	};
+
 	ChunkManager(const Terrain& terrain, const std::size_t chunkSize, const int pixelSizeMultiplier,
 	             const SDL_Color& color, Scene& scene, EnemyManager& enemyManager);
+	/* Streams a world of chunksX * chunksY chunks. Chunks are generated from seed when they come
+	 * in range and unloaded again when they are far away, so startup time and memory do not
+	 * depend on the size of the world. Edited chunks keep their terrain when unloaded, it is
+	 * moved to a TerrainStore so memory use does not grow with the amount of edited chunks.
+	 *
+	 * @param shapeSize Shape size passed to the generator.
+	 * @param bake Chunks in the bake are loaded from it instead of being generated. Ignored if
+	 *			   it was baked from another world.
+	 */
+	ChunkManager(const TerrainGenerator& generator, const std::uint32_t seed,
+	             const std::size_t shapeSize, const std::size_t chunksX, const std::size_t chunksY,
+	             const std::size_t chunkSize, const int pixelSizeMultiplier, const SDL_Color& color,
+	             Scene& scene, EnemyManager& enemyManager,
+	             std::optional<WorldBake> bake = std::nullopt);
 
 	~ChunkManager();
 
@@ -55,23 +101,87 @@ public:
 	 * @param range The range to remove from. (Radius of circle).
 	 */
 	void changeTerrainInRange(const Vec2& center, int range, const unsigned char value);
+	// Sets every cell between the corners, which are included.
+	void changeTerrainRect(const Vec2& corner1, const Vec2& corner2, const unsigned char value);
+	/* Sets every cell in range of the line from start to end, like changeTerrainInRange moved
+	 * along it.
+	 */
+	void changeTerrainCapsule(const Vec2& start, const Vec2& end, const int range,
+	                          const unsigned char value);
 	/* Get the array indices of the terrain pixel at the given world position.
 	 *
-	 * @param position Position to translate to indices.
-	 * @return Array indices of the world position.
+	 * @param position Position to translate to indices, relative to the world origin.
+	 * @return Array indices of the world position. Positions outside the world give indices
+	 * outside the terrain.
 	 */
 	std::pair<std::size_t, std::size_t> posToTerrainCoord(const Vec2& position) const;
 
-	std::size_t getChunksX() const { return chunks.empty() ? 0 : chunks[0].size(); }
-	std::size_t getChunksY() const { return chunks.size(); }
+	/* Positions are floats relative to a floating origin, which is moved in steps of whole
+	 * chunks to stay close to pos. That keeps positions small, so collisions and rendering are
+	 * as precise far out in a large world as they are close to where it starts.
+	 * Moves the loaded chunks when the origin moves, the caller has to move everything else
+	 * with the returned offset, see Scene::shiftOrigin.
+	 *
+	 * @param pos Position to keep close to the origin. Probably want this to be the player
+	 * position.
+	 * @return Offset that was added to every position, zero if the origin did not move.
+	 */
+	Vec2 recenterOrigin(const Vec2& pos);
+	// @return World cell at position (0, 0).
+	std::pair<std::ptrdiff_t, std::ptrdiff_t> getOriginCell() const {
+		return std::make_pair(originCellX, originCellY);
+	}
+
+	std::size_t getChunksX() const { return chunksX; }
+	std::size_t getChunksY() const { return chunksY; }
 	std::size_t getChunkSize() const { return chunkSize; }
-	const std::vector<std::vector<Chunk>>& getChunks() const { return chunks; }
+	// @return The chunk at chunk coordinates (x, y), or nullptr if it is not loaded.
+	const Chunk* getChunk(const std::size_t x, const std::size_t y) const;
+	std::size_t getLoadedChunkCount() const { return chunks.size(); }
+	bool isStreaming() const { return streaming.has_value(); }
+	// @return World position of the middle of the terrain.
+	Vec2 getWorldCenter() const;
 	int getPixelSize() const { return pixelSize; }
+	const LoadTimings& getLoadTimings() const { return loadTimings; }
+	/* Looks up the distance field of the chunk pos is in. Only active chunks have one.
+	 * Distances stop at DistanceField::maxDistance cells.
+	 *
+	 * @return Nothing if pos is not in an active chunk.
+	 */
+	std::optional<WallDistance> getWallDistance(const Vec2& pos) const;
+	/* Direction to follow from pos to reach the player around the terrain, see FlowField. The
+	 * field covers the active chunks and is rebuilt when the player moves to another cell.
+	 *
+	 * @return Unit vector, or nothing where there is no path or no field yet.
+	 */
+	std::optional<Vec2> getFlowDirection(const Vec2& pos) const;
+	const FlowField& getFlowField() const { return flowField; }
+	/* Connected region of empty cells that pos is in. Regions are joined across the borders of
+	 * the loaded chunks, cells that are only connected through unloaded chunks are in different
+	 * regions.
+	 *
+	 * @return Nothing if pos is in a filled cell or a chunk that is not loaded, or if chunks were
+	 * loaded or changed since the last update.
+	 */
+	std::optional<std::uint32_t> getRegion(const Vec2& pos) const;
+	// @return If a path over empty cells between a and b exists in the loaded chunks.
+	bool isConnected(const Vec2& a, const Vec2& b) const;
+	// @return If pos is in the region the player was in at the last update.
+	bool isConnectedToPlayer(const Vec2& pos) const;
 	// DEPRECATED, does not return a correct tree.
 	const Tree2D& getTree() const { return terrainTree; }
 	Scene& getScene() const { return scene; }
 
+	// @return Spawn positions in all loaded chunks.
 	std::vector<Vec2> getAllSpawns() const;
+	// Loads the chunks that would be active with the player at pos, and returns their spawns.
+	std::vector<Vec2> getSpawnsAround(const Vec2& pos);
+	/* Loads every chunk that is kept loaded with the player at pos, so the first frame there
+	 * does not have to. Safe to call on a worker thread before the manager is used elsewhere.
+	 *
+	 * @param progress Counts the chunks as they are done if not null.
+	 */
+	void preloadAround(const Vec2& pos, LoadingProgress* progress = nullptr);
 
 private:
 	Scene& scene;
@@ -82,13 +192,88 @@ private:
 	int pixelSize;
 
 	const std::size_t chunkSize;
+	const std::size_t chunksX;
+	const std::size_t chunksY;
 	const std::size_t terrainXSize;
 	const std::size_t terrainYSize;
-	std::vector<std::vector<Chunk>> chunks;
+	// Loaded chunks, key is chunk position (x, y). Heap allocated so colliders can keep a
+	// reference to their chunk.
+	std::map<std::pair<std::size_t, std::size_t>, std::unique_ptr<Chunk>> chunks;
+	// World cell at position (0, 0), see recenterOrigin.
+	std::ptrdiff_t originCellX = 0;
+	std::ptrdiff_t originCellY = 0;
+	// The origin is moved when pos gets further than this many chunks away from it.
+	constexpr static int recenterChunks = 8;
+	// @return Position of the top left corner of chunk (x, y), relative to the origin.
+	Vec2 getChunkOrigin(const std::size_t x, const std::size_t y) const;
 	constexpr static int chunkRange = 1;
 	std::vector<std::reference_wrapper<Chunk>> activeChunks;
-	std::vector<std::vector<Chunk>> splitToChunks(const Terrain& terrain,
-	                                              const std::size_t chunkSize);
+	LoadTimings loadTimings;
+	// Builds the chunks in parallel.
+	void splitToChunks(const Terrain& terrain);
+
+	struct Streaming {
+		TerrainGenerator generator;
+		std::uint32_t seed;
+		std::size_t shapeSize;
+		std::optional<WorldBake> bake;
+		TerrainStore store;  // Terrain of edited chunks that have been unloaded
+	};
+	std::optional<Streaming> streaming;
+	// Chunks further away than this from the center chunk are unloaded when streaming.
+	// Chunks one step outside the active range stay loaded, so they are ready before they are
+	// needed.
+	constexpr static int unloadRange = chunkRange + 2;
+	// Max amount of unloaded edited chunks kept decoded in the store.
+	constexpr static std::size_t storeResidentLimit = 16;
+	// Positions of loaded chunks that have been changed since they were loaded.
+	std::set<std::pair<std::size_t, std::size_t>> editedChunks;
+
+	/* Distance fields of the active chunks. Each one reaches a cell into the neighbours, so
+	 * positions anywhere in the chunk can be sampled.
+	 */
+	std::map<std::pair<std::size_t, std::size_t>, DistanceField> distanceFields;
+	// First global region of every loaded chunk, its regions follow after that.
+	std::map<std::pair<std::size_t, std::size_t>, std::uint32_t> regionOffsets;
+	// Region every global region is joined into, see getRegion.
+	std::vector<std::uint32_t> regionRoots;
+	std::optional<std::uint32_t> playerRegion;
+	// Chunks were loaded, unloaded or changed since the regions were joined.
+	bool regionsOutdated = true;
+	// Joins the regions of the loaded chunks where they touch.
+	void updateRegions();
+
+	FlowField flowField;
+	// Built on a worker from a snapshot of the active chunks, swapped in when it is done.
+	std::future<FlowField> pendingFlowField;
+	// The terrain or the active chunks changed since the flow field was started.
+	bool flowFieldOutdated = false;
+	/* Starts building the flow field towards the player if it is outdated or leads to another
+	 * cell, and no build is running already.
+	 */
+	void updateFlowField(const Vec2& playerPos);
+	// Fills window from the loaded chunks, see DistanceField::CellReader.
+	void readCells(CellGrid& window, const std::ptrdiff_t x, const std::ptrdiff_t y) const;
+
+	/* Only the active chunks keep their colliders, render cache and spawn positions. The ring
+	 * just outside them is built on workers, so it is ready before the player gets there, and
+	 * chunks further away are made compact.
+	 */
+	void updateResidency(const std::size_t midX, const std::size_t midY, const int range);
+	// @return The chunk at chunk position (x, y), generating it first if it is not loaded.
+	Chunk& loadChunk(const std::size_t x, const std::size_t y);
+	// Loads the chunks in range of chunk (midX, midY) that are not loaded, in parallel.
+	void loadChunksInRange(const std::size_t midX, const std::size_t midY, const int range,
+	                       LoadingProgress* progress = nullptr);
+	/* Creates chunk (x, y) from stored terrain, the bake or the generator. Safe to call on
+	 * different threads at the same time.
+	 *
+	 * @param stored Terrain from the store, which can not be read from several threads.
+	 */
+	std::unique_ptr<Chunk> createChunk(const std::size_t x, const std::size_t y,
+	                                   std::optional<Terrain>&& stored, LoadTimings& timings);
+	std::optional<Terrain> takeStored(const std::size_t x, const std::size_t y);
+	void unloadDistantChunks(const std::size_t midX, const std::size_t midY);
 	std::pair<std::size_t, std::size_t> posToChunk(
 	    const std::pair<std::size_t, std::size_t>& pos) const;
 	/* @param x Center X-position in chunk coordinates.
@@ -101,7 +286,12 @@ private:
 	                                                                       const std::size_t y,
 	                                                                       const int range) const;
 
-	std::queue<TerrainChange> pendingTerrainChanges;
+	// Changes made since the last update, in world cells. Single cells are spans of one.
+	std::vector<TerrainSpan> pendingTerrainSpans;
+	/* Sorts the pending spans into one bucket per chunk, then coalesces and applies every
+	 * chunk's spans in parallel. The rebuilds they start also run in parallel, see
+	 * Chunk::startRebuild.
+	 */
 	void executeTerrainChanges();
 
 	// DEPRECATED. TerrainManager does not know about all it's terrainColliders.
@@ -111,3 +301,5 @@ private:
 
 	SDL_Color color;
 };
+
+std::ostream& operator<<(std::ostream& os, const ChunkManager::LoadTimings& timings);
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+#include "engine/vector2D.h"
+#include "terrain/cellGrid.h"
+
+/* Distance from the cells of an area to the closest filled cell, capped at maxDistance.
+ * Computed with a two pass Euclidean distance transform, first along columns and then along
+ * rows. Because of the cap a changed cell only affects cells up to maxDistance away, so updates
+ * only transform a window around the changes.
+ */
+class DistanceField {
+public:
+	// In cells.
+	static constexpr int maxDistance = 16;
+
+	/* Fills window with the cells starting at cell (x, y) in world cells. Cells outside the
+	 * world or in chunks that are not loaded should be left empty.
+	 */
+	using CellReader = std::function<void(CellGrid& window, std::ptrdiff_t x, std::ptrdiff_t y)>;
+
+	struct Sample {
+		float distance;  // In cells
+		// Direction away from the closest filled cell. Zero inside filled cells.
+		Vec2 direction;
+	};
+
+	/* Covers the cells in [originX, originX + xSize) x [originY, originY + ySize), which can
+	 * reach outside the world. Every cell starts out at maxDistance, call update to fill it.
+	 */
+	DistanceField(const std::ptrdiff_t originX, const std::ptrdiff_t originY,
+	              const std::size_t xSize, const std::size_t ySize);
+
+	// Computes the cells in [x1, x2] x [y1, y2] again, in world cells and clipped to the field.
+	void update(const CellReader& readCells, std::ptrdiff_t x1, std::ptrdiff_t y1,
+	            std::ptrdiff_t x2, std::ptrdiff_t y2);
+	void update(const CellReader& readCells) {
+		update(readCells, originX, originY, originX + xSize - 1, originY + ySize - 1);
+	}
+
+	// @return Distance of the cell at world cell (x, y), which has to be inside the field.
+	float getDistance(const std::ptrdiff_t x, const std::ptrdiff_t y) const {
+		return distances[(y - originY) * xSize + x - originX];
+	}
+	/* Interpolates between the cell centers around a position. The position is split into a
+	 * world cell and an offset inside it, so it stays precise far away from the world origin.
+	 *
+	 * @param x, y World cell the position is in.
+	 * @param offset Position inside the cell, in [0, 1).
+	 * Has to be at least half a cell inside the field, see contains.
+	 */
+	Sample sample(const std::ptrdiff_t x, const std::ptrdiff_t y, const Vec2& offset) const;
+	bool contains(const std::ptrdiff_t x, const std::ptrdiff_t y, const Vec2& offset) const;
+
+	std::ptrdiff_t getOriginX() const { return originX; }
+	std::ptrdiff_t getOriginY() const { return originY; }
+	std::size_t getXSize() const { return xSize; }
+	std::size_t getYSize() const { return ySize; }
+
+private:
+	std::ptrdiff_t originX;
+	std::ptrdiff_t originY;
+	std::size_t xSize;
+	std::size_t ySize;
+	std::vector<float> distances;
+};
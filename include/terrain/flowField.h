@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "engine/vector2D.h"
+#include "terrain/cellGrid.h"
+
+/* Directions towards a target cell over the empty cells of an area, so every enemy following
+ * it shares one search instead of finding its own path. Built with Dijkstra from the target,
+ * using a bucket queue since all step costs are small integers. Steps close to terrain cost
+ * more, so the paths keep away from walls.
+ */
+class FlowField {
+public:
+	static constexpr std::uint32_t straightCost = 10;
+	static constexpr std::uint32_t diagonalCost = 14;
+	// Steps into cells closer to terrain than this, in cells, cost extra.
+	static constexpr int avoidDistance = 12;
+	// Extra cost for every cell closer than avoidDistance.
+	static constexpr std::uint32_t nearWallCost = 4;
+
+	// Field without any directions.
+	FlowField();
+	/* @param cells Terrain of the area, starting at world cell (originX, originY).
+	 * @param wallDistance Distance to the closest terrain for every cell of the area, row by
+	 * row, see DistanceField.
+	 * @param targetX, targetY World cell the paths lead to. Has to be an empty cell in the area.
+	 */
+	FlowField(const CellGrid& cells, const std::span<const float> wallDistance,
+	          const std::size_t originX, const std::size_t originY, const std::size_t targetX,
+	          const std::size_t targetY);
+
+	/* @return Unit vector towards the next cell on the path from world cell (x, y). Nothing at
+	 * the target, outside the area, or where the target can not be reached from.
+	 */
+	std::optional<Vec2> getDirection(const std::size_t x, const std::size_t y) const;
+	// @return Cost of the path from world cell (x, y), or nothing if there is none.
+	std::optional<std::uint32_t> getCost(const std::size_t x, const std::size_t y) const;
+
+	bool isEmpty() const { return costs.empty(); }
+	std::size_t getTargetX() const { return targetX; }
+	std::size_t getTargetY() const { return targetY; }
+
+private:
+	std::size_t originX;
+	std::size_t originY;
+	std::size_t xSize;
+	std::size_t ySize;
+	std::size_t targetX;
+	std::size_t targetY;
+
+	static constexpr std::uint32_t unreached = UINT32_MAX;
+	std::vector<std::uint32_t> costs;
+	// Index of the step to take from every cell, noDirection where there is none.
+	std::vector<std::uint8_t> directions;
+	static constexpr std::uint8_t noDirection = 8;
+
+	bool inside(const std::ptrdiff_t x, const std::ptrdiff_t y) const {
+		return x >= 0 && y >= 0 && x < static_cast<std::ptrdiff_t>(xSize) &&
+		       y < static_cast<std::ptrdiff_t>(ySize);
+	}
+	/* @return If step can be taken from area cell (x, y). Diagonal steps can not cut the corner
+	 * of a filled cell.
+	 */
+	bool canStep(const CellGrid& cells, const std::size_t x, const std::size_t y,
+	             const int step) const;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "engine/unionFind.h"
+#include "terrain/terrain.h"
+
+/* Connected regions of empty cells in one chunk, where cells sharing a side are connected.
+ * Opening cells only joins regions, so that is done in place with a union-find. Filling cells
+ * can split a region, which needs the whole chunk labelled again.
+ */
+class RegionLabels {
+public:
+	static constexpr std::uint32_t noRegion = 0;
+
+	RegionLabels();
+	RegionLabels(const Terrain& terrain);
+
+	// Joins the regions around cells, which have been made empty in terrain.
+	void open(const Terrain& terrain,
+	          const std::span<const std::pair<std::size_t, std::size_t>> cells);
+
+	/* @return Region of cell (x, y), the same for every cell connected to it, or noRegion if it
+	 * is filled. Regions are in [1, getLabelCount()).
+	 */
+	std::uint32_t getRegion(const std::size_t x, const std::size_t y) const {
+		return roots[labels[y * xSize + x]];
+	}
+	// Upper bound of the regions, some labels can be unused after opening cells.
+	std::uint32_t getLabelCount() const { return roots.size(); }
+
+private:
+	std::size_t xSize;
+	std::size_t ySize;
+	// Label of every cell, row by row. Connected cells can have different labels that are
+	// joined in sets.
+	std::vector<std::uint32_t> labels;
+	UnionFind sets;
+	// Representing label of every label's set, so lookups do not need to walk the sets.
+	std::vector<std::uint32_t> roots;
+
+	// Gives cell (x, y) a label if it has none, and joins it with its labelled neighbours.
+	void joinNeighbours(const Terrain& terrain, const std::size_t x, const std::size_t y);
+	void updateRoots();
+};
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "terrain/terrain.h"
+
+/* Cells of a chunk that an enemy can spawn at. A cell can be spawned at when the spawn circle
+ * around it fits inside the chunk and is empty, which is the empty space eroded by the circle.
+ * Kept as a bitmap that is only recomputed around changed cells.
+ */
+class SpawnMap {
+public:
+	// Radius of the spawn circle in cells.
+	static constexpr int minSpace = 15;
+	// Half height of the spawn circle at every column offset from the center.
+	static const std::array<int, minSpace> circleY;
+
+	// Map without any spawnable cells.
+	SpawnMap();
+	SpawnMap(const Terrain& terrain);
+
+	/* Updates the map after cells in the columns [x1, x2] of terrain were changed.
+	 * The runs of empty cells in those columns are recomputed, and only the centers whose circle
+	 * can reach a changed run are checked again, in the rows the changed runs cover.
+	 */
+	void update(const Terrain& terrain, const std::size_t x1, const std::size_t x2);
+
+	bool isSpawnable(const std::size_t x, const std::size_t y) const {
+		return bits[y * wordsPerRow + x / 64] >> (x % 64) & 1;
+	}
+	std::size_t getCount() const { return count; }
+	// @return A uniformly random spawnable cell, or nothing if there are none.
+	std::optional<std::pair<std::size_t, std::size_t>> sample(std::mt19937& randGen) const;
+
+private:
+	std::size_t xSize;
+	std::size_t ySize;
+	std::size_t wordsPerRow;
+	/* For every cell, row by row, how many cells the empty run it is in reaches both up and down,
+	 * counting itself. 0 for filled cells. The circle column at offset dx fits at a center if
+	 * this is larger than circleY[|dx|] there.
+	 */
+	std::vector<std::uint16_t> reach;
+	std::vector<std::uint64_t> bits;
+	std::size_t count;
+
+	// @return Range of rows where reach changed, empty if none did.
+	std::optional<std::pair<std::size_t, std::size_t>> updateColumn(const Terrain& terrain,
+	                                                                const std::size_t x);
+	// Checks every center in [x1, x2] x [y1, y2] again, clipped to where the circle fits.
+	void updateCenters(std::size_t x1, std::size_t y1, std::size_t x2, std::size_t y2);
+	bool fits(const std::size_t x, const std::size_t y) const;
+};
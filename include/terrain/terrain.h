@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
 struct Terrain {
@@ -12,5 +14,8 @@ struct Terrain {
 	std::size_t getXSize() const { return map.empty() ? 0 : map[0].size(); }
 	std::size_t getYSize() const { return map.size(); }
 
+	// @return FNV-1a hash of the size and cells, for checking that terrain did not change.
+	std::uint64_t getHash() const;
+
 	void printTerrain() const;
 };
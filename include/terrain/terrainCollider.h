@@ -1,11 +1,8 @@
 #pragma once
 
-#include <memory>
-
 #include "engine/collision.h"
 
 class Chunk;
-class GameObject;
 
 class TerrainCollider : public LineCollider {
 public:
@@ -27,6 +24,4 @@ private:
 	Chunk& chunk;
 
 	Vec2 position;
-
-	std::unique_ptr<GameObject> fakeObject;
 };
@@ -1,18 +1,57 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <random>
 
+#include "terrain/cellGrid.h"
 #include "terrain/terrain.h"
 
 class ChunkManager;
+class ThreadPool;
+class WallCounter;
 
 class TerrainGenerator {
 public:
 	TerrainGenerator(std::mt19937& randGen);
 
+	// Seconds spent on each stage of generating terrain.
+	struct StageTimings {
+		double shape = 0;
+		double corners = 0;
+		double edges = 0;
+		double details = 0;
+
+		StageTimings& operator+=(const StageTimings& other);
+	};
+
+	// @param timings Time spent on every stage is added to this if it is not null.
 	Terrain generateTerrain(const std::size_t xSize, const std::size_t ySize,
-	                        const std::size_t shapeSize);
+	                        const std::size_t shapeSize, StageTimings* timings = nullptr);
+	/* Generates terrain with the same stages as above, split into tiles that are calculated in
+	 * parallel on pool. The random value of every cell is a hash of seed and its position, so the
+	 * result only depends on seed and the parameters, never on the amount of threads.
+	 */
+	Terrain generateTerrain(const std::size_t xSize, const std::size_t ySize,
+	                        const std::size_t shapeSize, const std::uint32_t seed,
+	                        ThreadPool& pool, StageTimings* timings = nullptr) const;
+	/* Generates the cells [x, x + xSize) * [y, y + ySize) of an unbounded world without edges.
+	 * A cell only depends on seed, the parameters and its position, so separately generated
+	 * neighbouring regions line up exactly.
+	 */
+	CellGrid generateRegion(const std::size_t x, const std::size_t y, const std::size_t xSize,
+	                        const std::size_t ySize, const std::size_t shapeSize,
+	                        const std::uint32_t seed, ThreadPool& pool) const;
+	/* Generates chunk (chunkX, chunkY) of a world of worldXSize * worldYSize cells, with the
+	 * cells within edgeThickness of the world edges filled.
+	 */
+	Terrain generateChunk(const std::size_t chunkX, const std::size_t chunkY,
+	                      const std::size_t chunkSize, const std::size_t worldXSize,
+	                      const std::size_t worldYSize, const std::size_t shapeSize,
+	                      const std::uint32_t seed, ThreadPool& pool) const;
+
+	// @return Hash of all the parameters, for recognizing terrain generated with them.
+	std::uint64_t getParameterHash() const;
 
 	double shapeFillProb;
 	int shapeGenerations;
@@ -128,4 +167,70 @@ private:
 
 	inline Neighbors getNeighbors(const std::size_t x, const std::size_t y,
 	                              const Terrain& terrain) const;
+
+	//----- PARALLEL GENERATION -----//
+
+	// Work is split into tiles of this size.
+	static constexpr std::size_t tileSize = 64;
+
+	struct Tile {
+		std::size_t x1, y1;  // Inclusive start
+		std::size_t x2, y2;  // Exclusive end
+	};
+
+	// Part of the world, in cells of the stage it is used for.
+	struct Region {
+		std::size_t x, y;  // World position of the first cell
+		std::size_t xSize, ySize;
+	};
+	// @return region grown by amount in every direction.
+	static Region expand(const Region& region, const std::size_t amount);
+
+	enum class RandomStage : std::uint32_t {
+		SHAPE_FILL = 0,
+		SHAPE_WALLS,
+		CORNER_FILL,
+	};
+
+	// @return Random value in [0, 1) belonging to the world position (x, y) in stage.
+	static double cellRandom(const std::uint32_t seed, const RandomStage stage,
+	                         const std::size_t x, const std::size_t y);
+	// Calls func for every tile of an xSize * ySize grid, in parallel on pool.
+	void forEachTile(const std::size_t xSize, const std::size_t ySize, ThreadPool& pool,
+	                 const std::function<void(const Tile&)>& func) const;
+	/* Runs generations of rule over the whole grid. Every tile reads the previous generation,
+	 * including the halo of cells around it, and writes to a second buffer. The buffers are
+	 * swapped between generations.
+	 *
+	 * @param rule Callable taking (tile, y, previous, counter, out) that writes the new values of
+	 *			   row y inside tile to out[tile.x1, tile.x2). counter holds the wall counts of the
+	 *			   previous generation.
+	 */
+	template <class Rule>
+	void calculateGenerations(CellGrid& grid, const int generations, ThreadPool& pool,
+	                          const Rule& rule) const;
+
+	CellGrid generateShape(const Region& region, const std::uint32_t seed,
+	                       ThreadPool& pool) const;
+	void calculateShape(const Tile& tile, const std::size_t y, const CellGrid& terrain,
+	                    const WallCounter& counter, unsigned char* out) const;
+	// @param shape Shape blocks covering shapeRegion, which must contain region.
+	CellGrid generateCorners(const CellGrid& shape, const Region& shapeRegion,
+	                         const Region& region, const std::size_t shapeSize,
+	                         const std::uint32_t seed, ThreadPool& pool) const;
+	// Returns true if the world position (x, y) is inside one of the generated corners of its
+	// shape block.
+	bool isInCorner(const std::size_t x, const std::size_t y, const Region& shapeRegion,
+	                const std::vector<std::vector<Corner>>& shapeCorners,
+	                const std::size_t shapeSize) const;
+	CellGrid addEdges(const CellGrid& reference, ThreadPool& pool) const;
+	void generateDetails(CellGrid& terrain, ThreadPool& pool) const;
+
+	// Same as the Terrain version, but uses randomValue instead of drawing from randGen.
+	unsigned char randomizeConsecutiveWall(const std::size_t x, const std::size_t y,
+	                                       const int range, const int wallLength,
+	                                       const double prob, const double randomValue,
+	                                       const CellGrid& terrain) const;
+	inline Neighbors getNeighbors(const std::size_t x, const std::size_t y,
+	                              const CellGrid& terrain) const;
 };
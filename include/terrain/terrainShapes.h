@@ -0,0 +1,70 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Cells [x1, x2) of row y, all set to value.
+struct TerrainSpan {
+	std::size_t y;
+	std::size_t x1;
+	std::size_t x2;
+	unsigned char value;
+};
+
+/* Terrain edits rasterized straight into spans, one for every row of the shape, clipped to a
+ * terrain of xSize * ySize cells. Positions are in cells and can be outside the terrain.
+ */
+namespace TerrainShapes {
+// Circles up to this radius use a precomputed stencil.
+constexpr int maxStencilRadius = 64;
+
+// round(sqrt(value)) for value >= 0, in integers so it can be used in constant expressions.
+constexpr int roundedSqrt(const int value) {
+	int root = 0;
+	// (root + 0.5)^2 <= value, multiplied by 4 to stay in integers
+	while (4 * (root + 1) * (root + 1) - 4 * (root + 1) + 1 <= 4 * value) root++;
+	return root;
+}
+
+/* Half width of the row dy cells from the center of a circle, so the row covers
+ * [-halfWidth, halfWidth]. Every row in [-radius, radius] has at least the center cell.
+ * This is the circle the terrain has always been removed in: the column x cells from the center
+ * covers the rows |dy| < round(sqrt((radius + 1)^2 - x^2)).
+ */
+constexpr int circleHalfWidth(const int radius, const int dy) {
+	const int outer = radius + 1;
+	int x = 0;
+	while (x + 1 < outer && dy < roundedSqrt(outer * outer - (x + 1) * (x + 1))) x++;
+	return x;
+}
+
+using Stencil = std::array<std::int16_t, maxStencilRadius + 1>;
+// Half widths of the rows 0 to radius of every circle up to maxStencilRadius.
+constexpr std::array<Stencil, maxStencilRadius + 1> circleStencils = [] {
+	std::array<Stencil, maxStencilRadius + 1> stencils{};
+	for (int radius = 0; radius <= maxStencilRadius; radius++)
+		for (int dy = 0; dy <= radius; dy++) stencils[radius][dy] = circleHalfWidth(radius, dy);
+	return stencils;
+}();
+
+void circle(const std::ptrdiff_t centerX, const std::ptrdiff_t centerY, const int radius,
+            const unsigned char value, const std::size_t xSize, const std::size_t ySize,
+            std::vector<TerrainSpan>& spans);
+// Corners are included.
+void rectangle(std::ptrdiff_t x1, std::ptrdiff_t y1, std::ptrdiff_t x2, std::ptrdiff_t y2,
+               const unsigned char value, const std::size_t xSize, const std::size_t ySize,
+               std::vector<TerrainSpan>& spans);
+// The circle moved along the line from start to end, like carving continuously between frames.
+void capsule(const std::ptrdiff_t startX, const std::ptrdiff_t startY, const std::ptrdiff_t endX,
+             const std::ptrdiff_t endY, const int radius, const unsigned char value,
+             const std::size_t xSize, const std::size_t ySize, std::vector<TerrainSpan>& spans);
+
+/* @return The cells spans sets, without overlaps, so every cell is only written once. Where
+ * spans overlap the later one is kept, like when they are applied in order. Touching spans
+ * with the same value are merged.
+ */
+std::vector<TerrainSpan> coalesce(const std::span<const TerrainSpan> spans);
+}  // namespace TerrainShapes
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "engine/mappedFile.h"
+#include "terrain/terrain.h"
+
+/* Terrain of chunks kept in a memory mapped file, so that the memory used does not grow with
+ * the amount of chunks stored. Every stored chunk gets a page in the file with one bit per
+ * cell. At most residentLimit chunks are kept decoded, the least recently used one is evicted
+ * when another is needed, and written back to its page if it was changed.
+ *
+ * Layout: a table with the page number + 1 of every chunk in the world, 0 if it has no page,
+ * followed by the pages. The file is scratch space and is removed with the store.
+ */
+class TerrainStore {
+public:
+	/* @param chunksX Amount of chunks in the world along the x-axis.
+	 * @param chunksY Amount of chunks in the world along the y-axis.
+	 * @param residentLimit Max amount of decoded chunks, at least 1.
+	 */
+	TerrainStore(const std::string& path, const std::size_t chunkSize, const std::size_t chunksX,
+	             const std::size_t chunksY, const std::size_t residentLimit);
+	~TerrainStore();
+
+	TerrainStore(const TerrainStore&) = delete;
+	TerrainStore& operator=(const TerrainStore&) = delete;
+	TerrainStore(TerrainStore&& other) noexcept;
+	TerrainStore& operator=(TerrainStore&&) = delete;
+
+	// @return True if chunk (x, y) has been stored.
+	bool contains(const std::size_t x, const std::size_t y) const;
+	/* @return The stored terrain of chunk (x, y), which must be stored. Valid until the store is
+	 *		   changed again.
+	 */
+	const Terrain& load(const std::size_t x, const std::size_t y);
+	// Stores terrain as chunk (x, y), replacing what was stored before.
+	void store(const std::size_t x, const std::size_t y, Terrain&& terrain);
+
+	std::size_t getResidentCount() const { return resident.size(); }
+	// @return Amount of chunks that have been written to the file.
+	std::size_t getPageCount() const { return pageCount; }
+
+private:
+	MappedFile file;
+	std::string path;
+
+	std::size_t chunkSize;
+	std::size_t chunksX;
+	std::size_t chunksY;
+	std::size_t residentLimit;
+	std::size_t tableBytes;
+	std::size_t pageBytes;
+	std::size_t pageCount;
+	std::size_t pageCapacity;
+
+	struct Resident {
+		Terrain terrain;
+		bool dirty;
+		std::list<std::size_t>::iterator lruPos;
+	};
+	// Decoded chunks, key is the chunk index
+	std::unordered_map<std::size_t, Resident> resident;
+	// Chunk indices of the resident chunks, most recently used first
+	std::list<std::size_t> lru;
+
+	std::size_t chunkIndex(const std::size_t x, const std::size_t y) const {
+		return y * chunksX + x;
+	}
+	std::uint32_t* table() { return reinterpret_cast<std::uint32_t*>(file.getWritableData()); }
+	const std::uint32_t* table() const {
+		return reinterpret_cast<const std::uint32_t*>(file.getData());
+	}
+	std::byte* page(const std::uint32_t number) {
+		return file.getWritableData() + tableBytes + number * pageBytes;
+	}
+
+	// Evicts chunks until there is room for one more.
+	void makeRoom();
+	void writePage(const std::size_t index, const Terrain& terrain);
+	Terrain readPage(const std::size_t index);
+};
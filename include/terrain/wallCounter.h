@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "terrain/cellGrid.h"
+
+/* Counts filled cells in square neighbourhoods in constant time per cell, independent of the
+ * range, using a summed-area table of the grid.
+ */
+class WallCounter {
+public:
+	WallCounter(const CellGrid& grid);
+
+	/* @return Amount of filled cells in the (2 * range + 1)^2 square centered at (x, y),
+	 *		   clipped to the grid. Includes the cell (x, y) itself.
+	 */
+	int count(const std::size_t x, const std::size_t y, const int range) const;
+	/* Writes count(x, y, range) for every x in [x1, x2) to out[x - x1].
+	 * Where the square is not clipped by the grid the loop is branch free, so it is vectorized.
+	 */
+	void countRow(const std::size_t y, const int range, const std::size_t x1,
+	              const std::size_t x2, int* out) const;
+
+private:
+	const std::size_t xSize;
+	const std::size_t ySize;
+	// (xSize + 1) * (ySize + 1) entries. Entry (x, y) is the sum of all cells above and left of it.
+	std::vector<std::uint32_t> table;
+
+	const std::uint32_t* tableRow(const std::size_t y) const {
+		return table.data() + y * (xSize + 1);
+	}
+};
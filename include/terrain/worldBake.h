@@ -0,0 +1,109 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include "engine/mappedFile.h"
+#include "terrain/chunk.h"
+#include "terrain/terrain.h"
+
+class TerrainGenerator;
+class ThreadPool;
+
+/* Pregenerated chunks of a world, stored in a file that is memory mapped when loaded. The file
+ * is used in place, only the terrain of a chunk is decoded when the chunk is loaded.
+ *
+ * Layout, in the byte order of the machine that baked it:
+ *	Header
+ *	ChunkEntry for every baked chunk, row by row
+ *	Terrain, segments and spawn cells of the chunks, every block starting 8 byte aligned
+ */
+class WorldBake {
+public:
+	static constexpr std::uint32_t version = 1;
+
+	enum class Encoding : std::uint32_t {
+		BITS = 0,  // One bit per cell, row by row
+		// Lengths of runs of equal cells as std::uint16_t, alternating between empty and filled
+		// and starting with empty.
+		RLE,
+	};
+
+	struct Header {
+		char magic[4];
+		std::uint32_t version;
+		std::uint32_t byteOrder;
+		std::uint32_t seed;
+		std::uint64_t key;  // makeKey of what the world was baked with
+		std::uint32_t chunkSize;
+		std::uint32_t shapeSize;
+		std::uint64_t worldChunksX, worldChunksY;  // Size of the whole world
+		std::uint64_t firstChunkX, firstChunkY;    // First baked chunk
+		std::uint32_t chunksX, chunksY;            // Amount of baked chunks
+		std::uint64_t entriesOffset;
+	};
+
+	struct ChunkEntry {
+		std::uint64_t terrainOffset;
+		std::uint32_t terrainBytes;
+		Encoding encoding;
+		std::uint64_t segmentsOffset;
+		std::uint32_t segmentCount;
+		std::uint32_t spawnCount;
+		std::uint64_t spawnsOffset;
+	};
+
+	// Part of the world to bake, in chunks.
+	struct Area {
+		std::size_t worldChunksX, worldChunksY;
+		std::size_t firstChunkX, firstChunkY;
+		std::size_t chunksX, chunksY;
+	};
+
+	/* Maps the bake at path.
+	 * @return Empty if the file is missing, is not a bake of this version or is damaged.
+	 */
+	static std::optional<WorldBake> open(const std::string& path);
+	/* Generates the chunks in area and writes them to path.
+	 *
+	 * @param compress Store the terrain of a chunk with RLE when that is smaller.
+	 * @return False if the file could not be written.
+	 */
+	static bool bake(const std::string& path, const TerrainGenerator& generator,
+	                 const std::uint32_t seed, const std::size_t shapeSize,
+	                 const std::size_t chunkSize, const Area& area, const bool compress,
+	                 ThreadPool& pool);
+	// Identifies the world generated by generator and seed with these sizes.
+	static std::uint64_t makeKey(const TerrainGenerator& generator, const std::uint32_t seed,
+	                             const std::size_t shapeSize, const std::size_t chunkSize,
+	                             const std::size_t worldChunksX, const std::size_t worldChunksY);
+
+	const Header& getHeader() const { return *header; }
+	// @return True if chunk (x, y) of the world is in the bake.
+	bool contains(const std::size_t x, const std::size_t y) const;
+
+	// The chunk (x, y) must be in the bake.
+	Terrain getTerrain(const std::size_t x, const std::size_t y) const;
+	std::span<const Chunk::Segment> getSegments(const std::size_t x, const std::size_t y) const;
+	std::span<const Chunk::SpawnCell> getSpawns(const std::size_t x, const std::size_t y) const;
+
+private:
+	WorldBake(MappedFile&& file);
+
+	MappedFile file;
+	const Header* header;
+	const ChunkEntry* entries;
+
+	const ChunkEntry& getEntry(const std::size_t x, const std::size_t y) const;
+	// @return True if every entry points inside the file.
+	bool validate() const;
+};
+
+static_assert(std::is_trivially_copyable_v<WorldBake::Header> &&
+              sizeof(WorldBake::Header) % 8 == 0);
+static_assert(std::is_trivially_copyable_v<WorldBake::ChunkEntry> &&
+              sizeof(WorldBake::ChunkEntry) % 8 == 0);
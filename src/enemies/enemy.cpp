@@ -32,7 +32,8 @@ void Enemy::initialize(const Scene& scene, const Vec2& startPos) {
 	combatScene = static_cast<const CombatScene*>(&scene);
 
 	// Initialize enemy at full speed towards player
-	const Vec2 playerDirection = Vec2(combatScene->player.getPosition() - position).normalized();
+	const Vec2 playerDirection =
+	    Vec2(combatScene->getPlayer().getPosition() - position).normalized();
 	velocity = playerDirection * moveSpeed;
 }
 
@@ -63,7 +64,7 @@ void Enemy::update(Scene& scene, const float deltaTime) {
 		healthbarBG.calculatePosition();
 		healthbarBG.update();
 		// Render healthbar
-		scene.getGame().getRenderManager().addRenderCall(healthbarBG.getRenderFunction(), this);
+		scene.getGame().getRenderManager().addWidget(healthbarBG, this, RenderManager::uiLayer);
 	}
 }
 
@@ -145,37 +146,35 @@ Vec2 Enemy::evade(const GameObject& target, const float& predictionMultiplier) c
 	return flee(futurePosition);  // Use seek to move towards this position
 }
 
+Vec2 Enemy::followFlow(const GameObject& target) const {
+	const std::optional<Vec2> direction =
+	    combatScene->getChunkManager().getFlowDirection(position);
+	if (!direction) return seek(target.getPosition());
+
+	const Vec2 desiredVelocity = *direction * moveSpeed;
+	return desiredVelocity - velocity;  // Return calculated force
+}
+
 void Enemy::avoidTerrain(const float strength, const float avoidDist) {
-	try {
-		// Find closest terrain object
-		const GameObject* closest =
-		    combatScene->getChunkManager().getTree().findClosestObject(position);
-		// Find the closest point to this enemy on the LineCollider
-		const Collision::Line& line = static_cast<LineCollider*>(closest->getCollider())->line;
-		const Vec2 closestPoint = Collision::closestPointOnLine(position, line);
-
-		const Vec2 dist{closestPoint - position};  // Find distance to the closest point
-		if (dist.dotProduct(dist) <= avoidDist * avoidDist) {
-			// Avoid the middle position of the collider
-			steering += flee(closest->getPosition()) * strength;
-		}
-	} catch (const int e) {
-		// Could not get the closest object from the tree, likely due to it being empty.
-		// Does not require further action, hence this catch block is empty.
-	}
+	const std::optional<ChunkManager::WallDistance> wall =
+	    combatScene->getChunkManager().getWallDistance(position);
+	// Outside the active chunks, or nothing close enough
+	if (!wall || wall->distance > avoidDist) return;
+
+	// Flee from a point towards the closest terrain
+	steering += flee(position - wall->direction) * strength;
 }
 
-std::function<void(Scene&)> Enemy::debugRender() const {
-	return [this](Scene& scene) {
-		GameObject::debugRender()(scene);  // Call parent debugRender
-
-		SDL_Renderer* renderer = scene.getGame().getRenderer();
-		// Draw line displaying steering direction and strength
-		SDL_SetRenderDrawColor(renderer, 0, 255, 255, 255);
-		SDL_RenderDrawLine(renderer, getScreenPosition().x, getScreenPosition().y,
-		                   getScreenPosition().x + steering.x * 0.1,
-		                   getScreenPosition().y + steering.y * 0.1);
-	};
+void Enemy::debugRender(Scene& scene) const {
+	GameObject::debugRender(scene);  // Call parent debugRender
+
+	// Draw line displaying steering direction and strength
+	const Vec2 start = getScreenPosition();
+	const Vec2 end = start + steering * 0.1f;
+	constexpr SDL_Color cyan{0, 255, 255, 255};
+	scene.getGame().getRenderManager().addLine(SDL_FPoint{start.x, start.y},
+	                                           SDL_FPoint{end.x, end.y}, cyan,
+	                                           RenderManager::debugLayer);
 }
 
 EnemyAttackPoint::EnemyAttackPoint() {
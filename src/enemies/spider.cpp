@@ -18,15 +18,23 @@ void SpiderEnemy::update(Scene& scene, const float deltaTime) {
 	// Different movement depending on the current state
 	switch (getState()) {
 		using enum EnemyStates;
-		case PURSUIT:
-			steering += pursuit(combatScene->player, 0.75f);
-			steering += seek(combatScene->player.getPosition()) * 0.75f;
+		case PURSUIT: {
+			const Player& player = combatScene->getPlayer();
+			const Vec2 playerDist = player.getPosition() - position;
+			// Around the terrain until close, then straight at the player
+			if (playerDist.dotProduct(playerDist) > directRange * directRange) {
+				steering += followFlow(player) * 1.5f;
+			} else {
+				steering += pursuit(player, 0.75f);
+				steering += seek(player.getPosition()) * 0.75f;
+			}
 			avoidOtherEnemies(0.5f);
 			attackRangeCheck();
 			break;
+		}
 
 		case EVADE:
-			steering += evade(combatScene->player, 0.4f);
+			steering += evade(combatScene->getPlayer(), 0.4f);
 			avoidOtherEnemies();
 			attackRangeCheck();
 			break;
@@ -35,7 +43,7 @@ void SpiderEnemy::update(Scene& scene, const float deltaTime) {
 			break;
 
 		case REPOSITION:
-			steering += flee(combatScene->player.getPosition()) * 1.75f;
+			steering += flee(combatScene->getPlayer().getPosition()) * 1.75f;
 			avoidOtherEnemies(0.3f);
 
 			// Change to pursuit after repositionTime has passed
@@ -60,14 +68,14 @@ void SpiderEnemy::attack(Scene& scene) {
 }
 
 void SpiderEnemy::attackRangeCheck() {
-	Vec2 dist = position - combatScene->player.getPosition();
+	Vec2 dist = position - combatScene->getPlayer().getPosition();
 	constexpr static float atkDist = 70.0f;
 	// Enter Attack state when closer than atkDist
 	if (dist.dotProduct(dist) <= atkDist * atkDist) {
 		setState(EnemyStates::ATTACK);
 
 		// Make spider point directly towards player
-		const Vec2 playerDir(combatScene->player.getPosition() - position);
+		const Vec2 playerDir(combatScene->getPlayer().getPosition() - position);
 		rotation = playerDir.toDegrees() + 90;
 	}
 }
@@ -41,25 +41,20 @@ void EnemyManager::updateTree() {
 
 EnemySpawner::EnemySpawner(EnemyManager& manager) : manager{manager}, timer{timeMax} {}
 
-void EnemySpawner::update(Scene& scene, const float deltaTime) {
-	if (spawnPositions.empty()) return;
-
+void EnemySpawner::update(Scene& scene, const float deltaTime,
+                          const PositionSampler& samplePosition) {
 	timer -= deltaTime;
 	if (timer <= 0) {
-		spawn(scene);
+		spawn(scene, samplePosition);
 		std::uniform_real_distribution<float> dist{timeMin, timeMax};
 		timer = dist(scene.getGame().randGen);
 	}
 }
 
-void EnemySpawner::updateSpawnPositions(std::vector<Vec2>&& newSpawns) {
-	spawnPositions = std::move(newSpawns);
-}
-
-void EnemySpawner::spawn(Scene& scene) {
-	std::uniform_int_distribution<std::size_t> dist{0, spawnPositions.size() - 1};
-	const std::size_t idx = dist(scene.getGame().randGen);
+void EnemySpawner::spawn(Scene& scene, const PositionSampler& samplePosition) {
+	const std::optional<Vec2> position = samplePosition(scene.getGame().randGen);
+	if (!position) return;
 
-	Enemy& enemy = scene.instantiate<SpiderEnemy>(spawnPositions[idx]);
+	Enemy& enemy = scene.instantiate<SpiderEnemy>(*position);
 	manager.addEnemy(enemy);
 }
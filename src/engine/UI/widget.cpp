@@ -1,8 +1,5 @@
 #include "engine/UI/widget.h"
 
-#include "engine/game.h"
-#include "engine/scene.h"
-
 namespace UI {
 
 Widget::Widget(Widget* parent, AnchorType anchorPosition) {
@@ -25,12 +22,6 @@ void Widget::render(SDL_Renderer* renderer) const {
 	}
 }
 
-// Creates a lambda of the render() function and returns it
-// To be used when adding render call to UIManager
-std::function<void(Scene&)> Widget::getRenderFunction() const {
-	return [this](Scene& scene) { this->render(scene.getGame().getRenderer()); };
-}
-
 void Widget::calculatePosition(const bool& calculateChildren) {
 	// No need to calculate position if widget does not have a parent
 	if (parent == nullptr) {
@@ -5,43 +5,43 @@
 #include "SDL2/SDL.h"
 #include "engine/scene.h"
 #include "scenes/combat_scene.h"
-
-Game::Game(const char* title, const int width, const int height)
-    : winDimensions{width, height},
-      window{nullptr},
-      renderer{nullptr},
+#include "scenes/loading_scene.h"
+
+Game::Game(const char* title, const int width, const int height,
+           const RenderBackend::Type backend)
+    : renderBackend{RenderBackend::create(backend)},
+      winDimensions{width, height},
+      renderMode{RenderMode::FULL_RESOLUTION},
+      worldTarget{nullptr},
       input{},
       mouseInput{},
       onMouseDown{},
       resourceManager{initializeResourceManager()} {
 	isRunning = true;
 
-	// Check that SDL initializes
-	if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-		std::cerr << "SDL could not be initialized:\n" << SDL_GetError();
+	// Check that SDL initializes and the window and renderer are created
+	if (!renderBackend->initialize(title, width, height)) {
+		std::cerr << "Render backend could not be initialized:\n" << SDL_GetError();
 		isRunning = false;
 		return;
 	}
 
-	// Create window and renderer
-	SDL_CreateWindowAndRenderer(width, height, 0, &window, &renderer);
-	SDL_SetWindowTitle(window, title);  // Set title
-
-	// Make alpha/transparency work
-	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
-
 #ifndef ASSETS_PATH
 	std::cerr << "ERROR: ASSETS_PATH not defined. Cannot load any textures." << std::endl;
 	clean();
 	std::terminate();
 #endif
+	// Every image is packed into the atlas before anything uses them
+	resourceManager.loadAtlas(*this);
+
 	// Initialize prevTime to ensure correct first deltaTime
 	prevTime = SDL_GetPerformanceCounter();
 
-	// Add scenes
+	// Add scenes, the world is generated while the loading scene is shown
 	scenes.reserve(sceneCount);
-	addScene<CombatScene>();
+	addScene<LoadingScene>();
 	changeScene(0);
+	loadScene<CombatScene>();
 
 	std::cout << "Initialized Game" << std::endl;
 }
@@ -88,12 +88,14 @@ void Game::update() {
 	const float deltaTime = (float)(nowTime - prevTime) / (float)SDL_GetPerformanceFrequency();
 	prevTime = nowTime;
 
-	renderManager.resetCallCnt();
+	renderManager.clear();
+
+	pollPendingScene();
 
 	// Call update on current scene
 	scenes[currentScene]->update(deltaTime);
 
-	// Stop anything with deleted parent from rendering
+	// Stop anything with deleted parent from rendering, and sort the rest
 	renderManager.update();
 
 	// Delete GameObjects marked for deletion
@@ -105,21 +107,73 @@ void Game::update() {
 }
 
 void Game::render() const {
+	SDL_Renderer* renderer = getRenderer();
+	if (renderer == nullptr) {
+		// Only count what would have been drawn
+		renderBackend->endFrame(renderManager.getCommands().size());
+		return;
+	}
+
 	SDL_SetRenderDrawColor(renderer, 84, 47, 63, 255);  // Set background color
 	SDL_RenderClear(renderer);                          // Clear screen
 
-	scenes[currentScene]->render(renderer);       // Render scene
-	renderManager.render(*scenes[currentScene]);  // Render overlays passed to RenderManager
+	if (renderMode == RenderMode::LOW_RESOLUTION)
+		renderWorld();
+	else
+		scenes[currentScene]->render(renderer);   // Render scene
+	renderManager.render(renderer);             // Render overlays passed to RenderManager
 
-	SDL_RenderPresent(renderer);  // Update screen
+	renderBackend->endFrame(renderManager.getCommands().size());  // Update screen
+}
+
+void Game::renderWorld() const {
+	SDL_Renderer* renderer = getRenderer();
+	SDL_SetRenderTarget(renderer, worldTarget);
+	// Scale is reset when changing target, so this only applies to the world target.
+	// Everything is positioned in window pixels, scaling down maps it to native art pixels.
+	SDL_RenderSetScale(renderer, 1.0f / pixelSize, 1.0f / pixelSize);
+	SDL_RenderClear(renderer);
+
+	scenes[currentScene]->render(renderer);
+
+	// Restores the window viewport and scale
+	SDL_SetRenderTarget(renderer, nullptr);
+	SDL_RenderCopy(renderer, worldTarget, nullptr, nullptr);  // Single upscale into the window
+}
+
+void Game::setRenderMode(const RenderMode mode) {
+	if (worldTarget != nullptr) {
+		SDL_DestroyTexture(worldTarget);
+		worldTarget = nullptr;
+	}
+	renderMode = RenderMode::FULL_RESOLUTION;
+
+	if (mode != RenderMode::LOW_RESOLUTION) return;
+	SDL_Renderer* renderer = getRenderer();
+	if (renderer == nullptr || !SDL_RenderTargetSupported(renderer)) {
+		std::cerr << "Render targets not supported, using full resolution rendering.\n";
+		return;
+	}
+
+	// Round up so that the upscaled target always covers the whole window
+	const int targetWidth = (static_cast<int>(winDimensions.x) + pixelSize - 1) / pixelSize;
+	const int targetHeight = (static_cast<int>(winDimensions.y) + pixelSize - 1) / pixelSize;
+	worldTarget = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+	                                targetWidth, targetHeight);
+	if (worldTarget == nullptr) {
+		std::cerr << "Could not create world render target:\n" << SDL_GetError() << std::endl;
+		return;
+	}
+	SDL_SetTextureScaleMode(worldTarget, SDL_ScaleModeNearest);  // Keep pixels sharp
+
+	renderMode = RenderMode::LOW_RESOLUTION;
 }
 
 void Game::clean() {
 	resourceManager.destroyTextures();
+	if (worldTarget != nullptr) SDL_DestroyTexture(worldTarget);
 
-	SDL_DestroyWindow(window);
-	SDL_DestroyRenderer(renderer);
-	SDL_Quit();
+	renderBackend->destroy();
 
 #ifdef DEBUG_GIZMO
 	std::cout << "\n";
@@ -142,6 +196,27 @@ void Game::addScene() {
 }
 // Create all valid templates
 template void Game::addScene<CombatScene>();
+template void Game::addScene<LoadingScene>();
+
+template <class T>
+void Game::loadScene() {
+	static_assert(std::is_base_of<Scene, T>(), "Scene must derive from type Scene.");
+
+	loadingProgress.start(0);
+	pendingScene = threadPool.submit([this]() -> std::unique_ptr<Scene> {
+		return std::make_unique<T>(*this, &loadingProgress);
+	});
+}
+template void Game::loadScene<CombatScene>();
+
+void Game::pollPendingScene() {
+	if (!pendingScene.valid() ||
+	    pendingScene.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+		return;
+
+	scenes.push_back(pendingScene.get());
+	changeScene(scenes.size() - 1);
+}
 
 ResourceManager Game::initializeResourceManager() const {
 #ifndef ASSETS_PATH
@@ -1,10 +1,12 @@
 #include "engine/gameObject.h"
 
+#include <algorithm>
 #include <cassert>
 
 #include "engine/game.h"
 #include "engine/resourceManager.h"
 #include "engine/scene.h"
+#include "engine/spriteBatch.h"
 
 // Initialize source rectangle (part of textureSheet that is displayed)
 // default to top left 32x32
@@ -34,8 +36,8 @@ GameObject::GameObject(const Vec2& srcRectSize) : GameObject{nullptr, srcRectSiz
 GameObject::GameObject() : GameObject{nullptr} {}
 
 void GameObject::initialize(const Scene& scene, const Vec2& startPosition) {
-	// Load texture
-	texture = scene.getGame().getResourceManager().loadTexture(getTextureSheet(), scene.getGame());
+	// Find texture in the atlas
+	region = scene.getGame().getResourceManager().getRegion(getTextureSheet(), scene.getGame());
 
 	// Initialize pivot
 	pivot.x = (float)destRect.w / 2 + pivotOffset.x;
@@ -55,6 +57,11 @@ void GameObject::initialize(const Scene& scene, const Vec2& startPosition) {
 	destRect.y = std::round(renderPosition.y);
 }
 
+void GameObject::shiftPosition(const Vec2& offset) {
+	position += offset;
+	if (collider) collider->shift(offset);
+}
+
 void GameObject::update(Scene& scene, const float deltaTime) {
 	if (!isStatic) {
 		position += velocity * deltaTime;
@@ -74,7 +81,7 @@ void GameObject::update(Scene& scene, const float deltaTime) {
 	if (isAnimated) animationUpdate(scene, deltaTime);
 
 #ifdef DEBUG_GIZMO
-	scene.getGame().getRenderManager().addRenderCall(debugRender(), this);
+	debugRender(scene);
 #endif
 }
 
@@ -90,9 +97,23 @@ void GameObject::setSize(const Vec2& newSize) {
 	pivot.y = (float)destRect.h / 2 + pivotOffset.y * size.y;
 }
 
-void GameObject::render(SDL_Renderer* renderer) const {
+void GameObject::render(SpriteBatch& batch) const {
 	if (!renderObject) return;
-	SDL_RenderCopyEx(renderer, texture, &srcRect, &destRect, rotation, &pivot, flipType);
+	// srcRect is relative to the texture sheet, which is somewhere in the atlas
+	const SDL_Rect src{region.rect.x + srcRect.x, region.rect.y + srcRect.y, srcRect.w, srcRect.h};
+	batch.add(region.texture, src, destRect, rotation, pivot, flipType);
+}
+
+bool GameObject::isOnScreen(const SDL_Rect& view) const {
+	// Rotation happens around the pivot, so the furthest corner from it bounds the sprite
+	const float dx = std::max(pivot.x, destRect.w - pivot.x);
+	const float dy = std::max(pivot.y, destRect.h - pivot.y);
+	const float radius = std::sqrt(dx * dx + dy * dy);
+
+	const float centerX = destRect.x + pivot.x;
+	const float centerY = destRect.y + pivot.y;
+	return centerX + radius >= view.x && centerX - radius <= view.x + view.w &&
+	       centerY + radius >= view.y && centerY - radius <= view.y + view.h;
 }
 
 void GameObject::animationUpdate(Scene& scene, const double& deltaTime) {
@@ -137,41 +158,44 @@ void GameObject::changeAnimation(const int sequenceId) {
 	animationCounter = 0;
 }
 
-std::function<void(Scene&)> GameObject::debugRender() const {
-	// Return lambda with debug render stuff
-	return [this](Scene& scene) {
-		SDL_Renderer* renderer = scene.getGame().getRenderer();
-		// Collider
-		SDL_SetRenderDrawColor(renderer, 255, 255, 0, 255);
-		const Vec2 camPos = scene.getCam().getPos();
-		switch (collider->getCollisionType()) {
-			using enum Collision::Types;
-			case CIRCLE: {
-				CircleCollider* circleCollider = static_cast<CircleCollider*>(collider.get());
-				Collision::drawCircleCollider(
-				    renderer, Collision::Circle{circleCollider->circle.position - camPos,
-				                                circleCollider->circle.radius});
-				break;
-			}
-			case LINE: {
-				LineCollider* lineCollider = static_cast<LineCollider*>(collider.get());
-				SDL_RenderDrawLineF(renderer, lineCollider->line.start.x - camPos.x,
-				                    lineCollider->line.start.y - camPos.y,
-				                    lineCollider->line.end.x - camPos.x,
-				                    lineCollider->line.end.y - camPos.y);
-			}
-			case POINT: {
-				PointCollider* pointCollider = static_cast<PointCollider*>(collider.get());
-				SDL_RenderDrawPoint(renderer, pointCollider->point.x - camPos.x,
-				                    pointCollider->point.y - camPos.y);
-			}
-		}
-		SDL_RenderDrawPoint(renderer, screenPosition.x, screenPosition.y);
-		SDL_SetRenderDrawColor(renderer, 0, 255, 0, 255);
-		SDL_RenderDrawLine(renderer, screenPosition.x, screenPosition.y,
-		                   screenPosition.x + velocity.x * 0.1,
-		                   screenPosition.y + velocity.y * 0.1);
-		SDL_SetRenderDrawColor(renderer, 255, 0, 0, 255);
-		SDL_RenderDrawRect(renderer, &destRect);
+void GameObject::debugRender(Scene& scene) const {
+	RenderManager& renderManager = scene.getGame().getRenderManager();
+	constexpr std::uint8_t layer = RenderManager::debugLayer;
+	// Collider
+	constexpr SDL_Color yellow{255, 255, 0, 255};
+	const Vec2 camPos = scene.getCam().getPos();
+	auto point = [&renderManager, yellow](const float x, const float y) {
+		renderManager.addFillRect(SDL_FRect{x, y, 1, 1}, yellow, layer);
 	};
+	switch (collider->getCollisionType()) {
+		using enum Collision::Types;
+		case CIRCLE: {
+			CircleCollider* circleCollider = static_cast<CircleCollider*>(collider.get());
+			const Vec2 center = circleCollider->circle.position - camPos;
+			renderManager.addCircle(SDL_FPoint{center.x, center.y}, circleCollider->circle.radius,
+			                        yellow, layer);
+			break;
+		}
+		case LINE: {
+			LineCollider* lineCollider = static_cast<LineCollider*>(collider.get());
+			const Vec2 start = lineCollider->line.start - camPos;
+			const Vec2 end = lineCollider->line.end - camPos;
+			renderManager.addLine(SDL_FPoint{start.x, start.y}, SDL_FPoint{end.x, end.y}, yellow,
+			                      layer);
+			break;
+		}
+		case POINT: {
+			PointCollider* pointCollider = static_cast<PointCollider*>(collider.get());
+			point(pointCollider->point.x - camPos.x, pointCollider->point.y - camPos.y);
+			break;
+		}
+	}
+	point(screenPosition.x, screenPosition.y);
+	renderManager.addLine(SDL_FPoint{screenPosition.x, screenPosition.y},
+	                      SDL_FPoint{screenPosition.x + velocity.x * 0.1f,
+	                                 screenPosition.y + velocity.y * 0.1f},
+	                      SDL_Color{0, 255, 0, 255}, layer);
+	renderManager.addRect(SDL_FRect{static_cast<float>(destRect.x), static_cast<float>(destRect.y),
+	                                static_cast<float>(destRect.w), static_cast<float>(destRect.h)},
+	                      SDL_Color{255, 0, 0, 255}, layer);
 }
@@ -0,0 +1,167 @@
+#include "engine/mappedFile.h"
+
+#include <utility>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+MappedFile::MappedFile(const std::string& path)
+    : data{nullptr}, size{0}, writable{false}, fileHandle{nullptr}, mappingHandle{nullptr} {
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+	                          FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return;
+	fileHandle = file;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+		close();
+		return;
+	}
+	size = fileSize.QuadPart;
+	if (!map()) close();
+}
+
+MappedFile::MappedFile(const std::string& path, const std::size_t size)
+    : data{nullptr}, size{0}, writable{true}, fileHandle{nullptr}, mappingHandle{nullptr} {
+	HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr,
+	                          CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) return;
+	fileHandle = file;
+	if (!resize(size)) close();
+}
+
+bool MappedFile::resize(const std::size_t newSize) {
+	if (!writable || fileHandle == nullptr) return false;
+	unmap();
+
+	LARGE_INTEGER end;
+	end.QuadPart = newSize;
+	if (!SetFilePointerEx(fileHandle, end, nullptr, FILE_BEGIN) || !SetEndOfFile(fileHandle)) {
+		close();
+		return false;
+	}
+	size = newSize;
+	if (map()) return true;
+	close();
+	return false;
+}
+
+bool MappedFile::map() {
+	mappingHandle = CreateFileMappingA(fileHandle, nullptr,
+	                                   writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+	if (mappingHandle == nullptr) return false;
+
+	data = static_cast<std::byte*>(
+	    MapViewOfFile(mappingHandle, writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, 0));
+	return data != nullptr;
+}
+
+void MappedFile::unmap() {
+	if (data) UnmapViewOfFile(data);
+	if (mappingHandle) CloseHandle(mappingHandle);
+	data = nullptr;
+	mappingHandle = nullptr;
+}
+
+void MappedFile::close() {
+	unmap();
+	if (fileHandle) CloseHandle(fileHandle);
+	fileHandle = nullptr;
+	size = 0;
+}
+#else
+MappedFile::MappedFile(const std::string& path) : data{nullptr}, size{0}, writable{false}, fd{-1} {
+	const int file = open(path.c_str(), O_RDONLY);
+	if (file < 0) return;
+
+	struct stat info;
+	if (fstat(file, &info) == 0 && info.st_size > 0) {
+		fd = file;
+		size = info.st_size;
+		if (!map()) size = 0;
+	}
+	// The mapping stays valid after the descriptor is closed
+	::close(file);
+	fd = -1;
+}
+
+MappedFile::MappedFile(const std::string& path, const std::size_t size)
+    : data{nullptr},
+      size{0},
+      writable{true},
+      fd{open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)} {
+	if (fd >= 0 && !resize(size)) close();
+}
+
+bool MappedFile::resize(const std::size_t newSize) {
+	if (!writable || fd < 0) return false;
+	unmap();
+
+	if (ftruncate(fd, newSize) != 0) {
+		close();
+		return false;
+	}
+	size = newSize;
+	if (map()) return true;
+	close();
+	return false;
+}
+
+bool MappedFile::map() {
+	void* mapping = mmap(nullptr, size, writable ? PROT_READ | PROT_WRITE : PROT_READ,
+	                     writable ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+	if (mapping == MAP_FAILED) return false;
+	data = static_cast<std::byte*>(mapping);
+	return true;
+}
+
+void MappedFile::unmap() {
+	if (data) munmap(data, size);
+	data = nullptr;
+}
+
+void MappedFile::close() {
+	unmap();
+	if (fd >= 0) ::close(fd);
+	fd = -1;
+	size = 0;
+}
+#endif
+
+MappedFile::~MappedFile() { close(); }
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+    : data{std::exchange(other.data, nullptr)},
+      size{std::exchange(other.size, 0)},
+      writable{other.writable},
+#ifdef _WIN32
+      fileHandle{std::exchange(other.fileHandle, nullptr)},
+      mappingHandle{std::exchange(other.mappingHandle, nullptr)}
+#else
+      fd{std::exchange(other.fd, -1)}
+#endif
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+	if (this == &other) return *this;
+	close();
+	data = std::exchange(other.data, nullptr);
+	size = std::exchange(other.size, 0);
+	writable = other.writable;
+#ifdef _WIN32
+	fileHandle = std::exchange(other.fileHandle, nullptr);
+	mappingHandle = std::exchange(other.mappingHandle, nullptr);
+#else
+	fd = std::exchange(other.fd, -1);
+#endif
+	return *this;
+}
@@ -0,0 +1,65 @@
+#include "engine/renderBackend.h"
+
+#include "SDL2/SDL.h"
+
+std::unique_ptr<RenderBackend> RenderBackend::create(const Type type) {
+	switch (type) {
+		case Type::SOFTWARE:
+			return std::make_unique<SoftwareBackend>();
+		case Type::NONE:
+			return std::make_unique<NullBackend>();
+		default:
+			return std::make_unique<AcceleratedBackend>();
+	}
+}
+
+void RenderBackend::endFrame(const std::size_t commandCount) {
+	stats.frames++;
+	stats.commands += commandCount;
+	present();
+}
+
+bool AcceleratedBackend::initialize(const char* title, const int width, const int height) {
+	if (SDL_Init(SDL_INIT_VIDEO) < 0) return false;
+
+	// Create window and renderer
+	if (SDL_CreateWindowAndRenderer(width, height, 0, &window, &renderer) < 0) return false;
+	SDL_SetWindowTitle(window, title);  // Set title
+
+	// Make alpha/transparency work
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+	return true;
+}
+
+void AcceleratedBackend::destroy() {
+	SDL_DestroyRenderer(renderer);
+	SDL_DestroyWindow(window);
+	renderer = nullptr;
+	window = nullptr;
+	SDL_Quit();
+}
+
+void AcceleratedBackend::present() { SDL_RenderPresent(renderer); }
+
+bool SoftwareBackend::initialize(const char*, const int width, const int height) {
+	// The software renderer does not need the video subsystem, so this works without a display
+	if (SDL_Init(0) < 0) return false;
+
+	surface = SDL_CreateRGBSurfaceWithFormat(0, width, height, 32, SDL_PIXELFORMAT_RGBA8888);
+	if (surface == nullptr) return false;
+	renderer = SDL_CreateSoftwareRenderer(surface);
+	if (renderer == nullptr) return false;
+
+	SDL_SetRenderDrawBlendMode(renderer, SDL_BLENDMODE_BLEND);
+	return true;
+}
+
+void SoftwareBackend::destroy() {
+	SDL_DestroyRenderer(renderer);
+	SDL_FreeSurface(surface);
+	renderer = nullptr;
+	surface = nullptr;
+	SDL_Quit();
+}
+
+bool NullBackend::initialize(const char*, const int, const int) { return true; }
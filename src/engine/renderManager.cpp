@@ -1,36 +1,137 @@
 #include "engine/renderManager.h"
 
+#include <algorithm>
+
+#include "engine/UI/widget.h"
+#include "engine/collision.h"
 #include "engine/gameObject.h"
 
-RenderManager::RenderManager() { renderCallCnt = 0; }
+namespace {
+bool sameColor(const SDL_Color& a, const SDL_Color& b) {
+	return a.r == b.r && a.g == b.g && a.b == b.b && a.a == b.a;
+}
+}  // namespace
 
-void RenderManager::addRenderCall(std::function<void(Scene&)> func, const GameObject* parent) {
-	if (renderCalls.size() > renderCallCnt) {
-		// Can just reassign existing variable
-		renderCalls[renderCallCnt].first = func;
-		renderCalls[renderCallCnt].second = parent;
-	} else {
-		renderCalls.push_back(std::make_pair(func, parent));  // Need to add more space
-	}
-	renderCallCnt++;
+RenderCommand& RenderManager::add(const RenderCommand::Type type, const SDL_Color& color,
+                                  const std::uint8_t layer) {
+	RenderCommand& command = commands.emplace_back();
+	command.type = type;
+	command.layer = layer;
+	command.sequence = commands.size() - 1;
+	command.texture = nullptr;
+	command.color = color;
+	return command;
+}
+
+void RenderManager::addFillRect(const SDL_FRect& rect, const SDL_Color& color,
+                                const std::uint8_t layer) {
+	add(RenderCommand::Type::FILL_RECT, color, layer).rect = rect;
+}
+
+void RenderManager::addRect(const SDL_FRect& rect, const SDL_Color& color,
+                            const std::uint8_t layer) {
+	add(RenderCommand::Type::RECT, color, layer).rect = rect;
+}
+
+void RenderManager::addLine(const SDL_FPoint& start, const SDL_FPoint& end, const SDL_Color& color,
+                            const std::uint8_t layer) {
+	add(RenderCommand::Type::LINE, color, layer).line = RenderCommand::Line{start, end};
 }
 
-void RenderManager::resetCallCnt() { renderCallCnt = 0; }
+void RenderManager::addCircle(const SDL_FPoint& center, const float radius,
+                              const SDL_Color& color, const std::uint8_t layer) {
+	add(RenderCommand::Type::CIRCLE, color, layer).circle = RenderCommand::Circle{center, radius};
+}
+
+void RenderManager::addSprite(SDL_Texture* texture, const SDL_Rect& src, const SDL_Rect& dest,
+                              const double angle, const SDL_Point& center,
+                              const SDL_RendererFlip flip, const std::uint8_t layer) {
+	if (!texture) return;
+	RenderCommand& command = add(RenderCommand::Type::SPRITE, SDL_Color{}, layer);
+	command.texture = texture;
+	command.sprite = RenderCommand::Sprite{src, dest, angle, center, flip};
+}
+
+void RenderManager::addWidget(const UI::Widget& widget, const GameObject* parent,
+                              const std::uint8_t layer) {
+	add(RenderCommand::Type::WIDGET, SDL_Color{}, layer).widget =
+	    RenderCommand::Widget{&widget, parent};
+}
+
+void RenderManager::clear() { commands.clear(); }
 
 void RenderManager::update() {
-	// Iterate over parents of render calls and check for deletion
-	for (auto it = renderCalls.cbegin(); it != renderCalls.cend();) {
-		if (it->second->deleteObject) {
-			it = renderCalls.erase(it);  // Remove render call
-			renderCallCnt--;             // Update call count
-		} else
-			it++;
-	}
+	// One pass instead of erasing every deleted widget from the middle
+	std::erase_if(commands, [](const RenderCommand& command) {
+		return command.type == RenderCommand::Type::WIDGET && command.widget.parent &&
+		       command.widget.parent->deleteObject;
+	});
+
+	// Sorts in place, the sequence breaks ties so the order on a layer is kept
+	std::sort(commands.begin(), commands.end(), [](const RenderCommand& a, const RenderCommand& b) {
+		if (a.layer != b.layer) return a.layer < b.layer;
+		return a.sequence < b.sequence;
+	});
 }
 
-void RenderManager::render(Scene& scene) const {
-	// Iterate over all render calls and call the render function
-	for (int i = 0; i < renderCallCnt; i++) {
-		renderCalls[i].first(scene);
+void RenderManager::render(SDL_Renderer* renderer) const {
+	bool colorSet = false;
+	SDL_Color drawColor{};
+	auto setColor = [&](const SDL_Color& color) {
+		if (colorSet && sameColor(color, drawColor)) return;
+		SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+		drawColor = color;
+		colorSet = true;
+	};
+
+	for (std::size_t i = 0; i < commands.size();) {
+		const RenderCommand& command = commands[i];
+		switch (command.type) {
+			using enum RenderCommand::Type;
+			case FILL_RECT: {
+				// Rectangles after each other with the same color are filled in one call
+				fillRects.clear();
+				for (; i < commands.size() && commands[i].type == FILL_RECT &&
+				       sameColor(commands[i].color, command.color);
+				     i++)
+					fillRects.push_back(commands[i].rect);
+				setColor(command.color);
+				SDL_RenderFillRectsF(renderer, fillRects.data(), fillRects.size());
+				continue;
+			}
+			case SPRITE: {
+				// Sprites after each other with the same texture are drawn in one call
+				for (; i < commands.size() && commands[i].type == SPRITE &&
+				       commands[i].texture == command.texture;
+				     i++) {
+					const RenderCommand::Sprite& sprite = commands[i].sprite;
+					spriteBatch.add(commands[i].texture, sprite.src, sprite.dest, sprite.angle,
+					                sprite.center, sprite.flip);
+				}
+				spriteBatch.render(renderer);
+				continue;
+			}
+			case RECT:
+				setColor(command.color);
+				SDL_RenderDrawRectF(renderer, &command.rect);
+				break;
+			case LINE:
+				setColor(command.color);
+				SDL_RenderDrawLineF(renderer, command.line.start.x, command.line.start.y,
+				                    command.line.end.x, command.line.end.y);
+				break;
+			case CIRCLE: {
+				setColor(command.color);
+				const Vec2 center{command.circle.center.x, command.circle.center.y};
+				Collision::drawCircleCollider(renderer,
+				                              Collision::Circle{center, command.circle.radius});
+				break;
+			}
+			case WIDGET:
+				command.widget.widget->render(renderer);
+				colorSet = false;  // Widgets set their own colors
+				break;
+		}
+		i++;
 	}
 }
@@ -1,12 +1,19 @@
 #include "engine/resourceManager.h"
 
+#include <algorithm>
 #include <filesystem>
 #include <iostream>
 #include <string>
+#include <vector>
 
 #include "SDL2/SDL_surface.h"
 #include "engine/game.h"
 
+namespace {
+// Largest atlas page, even if the renderer supports larger textures
+constexpr int maxAtlasSize = 4096;
+}  // namespace
+
 #ifndef NDEBUG
 #define ASSERT(condition, message, game)                                                 \
 	do {                                                                                 \
@@ -25,28 +32,49 @@
 
 ResourceManager::ResourceManager(std::string&& assetsPath) : assetsPath{std::move(assetsPath)} {}
 
-SDL_Texture* ResourceManager::loadTexture(const std::string_view filename, Game& game) {
-	// Load texture if it is not already loaded
-	if (!loadedTextures.count(filename)) {
-		std::string path{assetsPath};
-		path += filename;
-		// Check that file exists
-		ASSERT(std::filesystem::exists(path),
-		       "Could not load texture \"" + static_cast<std::string>(filename) + "\"", game);
-		// Store loaded textures to avoid unnecessary load calls
-		SDL_Surface* surface = SDL_LoadBMP(path.c_str());
-		SDL_Texture* texture = SDL_CreateTextureFromSurface(game.getRenderer(), surface);
-		loadedTextures[filename] = texture;
-		SDL_FreeSurface(surface);
+void ResourceManager::loadAtlas(Game& game) {
+	// Sorted by name, so the atlas is the same every time
+	std::vector<std::filesystem::path> paths;
+	std::error_code error;  // A missing folder packs nothing, getRegion reports the files
+	for (const auto& entry : std::filesystem::directory_iterator(assetsPath, error))
+		if (entry.is_regular_file() && entry.path().extension() == ".bmp")
+			paths.push_back(entry.path());
+	std::sort(paths.begin(), paths.end());
+
+	std::vector<std::pair<std::string, SDL_Surface*>> images;
+	for (const std::filesystem::path& path : paths) {
+		SDL_Surface* surface = SDL_LoadBMP(path.string().c_str());
+		if (surface == nullptr) {
+			std::cerr << "Could not load image " << path << ":\n" << SDL_GetError() << std::endl;
+			continue;
+		}
+		images.emplace_back(path.filename().string(), surface);
 	}
 
-	return loadedTextures[filename];
+	// Pages as large as the renderer allows, within reason
+	int maxSize = maxAtlasSize;
+	SDL_RendererInfo info;
+	if (game.getRenderer() != nullptr && SDL_GetRendererInfo(game.getRenderer(), &info) == 0 &&
+	    info.max_texture_width > 0 && info.max_texture_height > 0)
+		maxSize = std::min({maxSize, info.max_texture_width, info.max_texture_height});
+
+	atlas.build(game.getRenderer(), images, maxSize);
+	for (auto& [name, surface] : images) SDL_FreeSurface(surface);
+	std::cout << "Packed " << images.size() << " images into " << atlas.getPageCount()
+	          << " atlas pages" << std::endl;
 }
 
-void ResourceManager::destroyTextures() {
-	for (auto [filename, texture] : loadedTextures) {
-		SDL_DestroyTexture(texture);
-		texture = nullptr;
-	}
-	loadedTextures.clear();
+const TextureAtlas::Region& ResourceManager::getRegion(const std::string_view filename,
+                                                       Game& game) {
+	if (const TextureAtlas::Region* region = atlas.find(filename)) return *region;
+
+	// Not packed, check that file exists
+	std::string path{assetsPath};
+	path += filename;
+	ASSERT(std::filesystem::exists(path),
+	       "Could not load texture \"" + static_cast<std::string>(filename) + "\"", game);
+	static const TextureAtlas::Region empty{};
+	return empty;
 }
+
+void ResourceManager::destroyTextures() { atlas.destroy(); }
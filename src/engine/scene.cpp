@@ -2,6 +2,8 @@
 
 #include <ranges>
 
+#include "engine/game.h"
+
 Scene::Scene(Game& game_) : game(game_) {}
 
 void Scene::initialize(GameObjectVector&& persistentObjects) {
@@ -16,6 +18,13 @@ void Scene::initialize() {
 
 void Scene::reset() { gameObjects.clear(); }
 
+void Scene::shiftOrigin(const Vec2& offset) {
+	for (const std::unique_ptr<GameObject>& object : gameObjects) object->shiftPosition(offset);
+	cam.setPos(cam.getPos() + offset);
+	// The tree keeps copies of the positions, terrain collisions later this frame search it
+	updateObjectTree();
+}
+
 void Scene::update(const float deltaTime) {
 	// Update all GameObjects
 	for (auto& object : gameObjects) {
@@ -50,9 +59,17 @@ void Scene::updateCollision() {
 }
 
 void Scene::render(SDL_Renderer* renderer) const {
+	// GameObjects are positioned relative to the camera, so the window is the visible area.
+	// The object tree is not used here since it can reference objects deleted after update.
+	const Vec2& winDimensions = game.getWinDimensions();
+	const SDL_Rect view{0, 0, static_cast<int>(winDimensions.x),
+	                    static_cast<int>(winDimensions.y)};
+
 	for (auto& object : gameObjects) {
-		object->render(renderer);
+		if (!object->isOnScreen(view)) continue;  // Culled
+		object->render(spriteBatch);
 	}
+	spriteBatch.render(renderer);
 }
 
 void Scene::updateObjectTree() {
@@ -0,0 +1,72 @@
+#include "engine/spriteBatch.h"
+
+#include <cmath>
+#include <utility>
+
+void SpriteBatch::add(SDL_Texture* texture, const SDL_Rect& src, const SDL_Rect& dest,
+                      const double angle, const SDL_Point& center, const SDL_RendererFlip flip) {
+	if (!texture) return;
+
+	Batch& batch = getBatch(texture);
+	const int first = batch.vertices.size();
+	const std::array<SDL_Vertex, 4> quad =
+	    makeQuad(batch.width, batch.height, src, dest, angle, center, flip, batch.color);
+	batch.vertices.insert(batch.vertices.end(), quad.begin(), quad.end());
+	for (const int corner : {0, 1, 2, 0, 2, 3}) batch.indices.push_back(first + corner);
+}
+
+void SpriteBatch::render(SDL_Renderer* renderer) {
+	for (std::size_t i = 0; i < batchCount; i++) {
+		Batch& batch = batches[i];
+		SDL_RenderGeometry(renderer, batch.texture, batch.vertices.data(), batch.vertices.size(),
+		                   batch.indices.data(), batch.indices.size());
+		batch.vertices.clear();
+		batch.indices.clear();
+	}
+	batchCount = 0;
+}
+
+SpriteBatch::Batch& SpriteBatch::getBatch(SDL_Texture* texture) {
+	// Few textures are used per frame, so searching is faster than hashing
+	for (std::size_t i = 0; i < batchCount; i++)
+		if (batches[i].texture == texture) return batches[i];
+
+	if (batchCount == batches.size()) batches.emplace_back();
+	Batch& batch = batches[batchCount++];
+	batch.texture = texture;
+	batch.width = batch.height = 1;
+	SDL_QueryTexture(texture, nullptr, nullptr, &batch.width, &batch.height);
+	batch.color = SDL_Color{255, 255, 255, 255};
+	SDL_GetTextureColorMod(texture, &batch.color.r, &batch.color.g, &batch.color.b);
+	SDL_GetTextureAlphaMod(texture, &batch.color.a);
+	return batch;
+}
+
+std::array<SDL_Vertex, 4> SpriteBatch::makeQuad(const int textureWidth, const int textureHeight,
+                                                const SDL_Rect& src, const SDL_Rect& dest,
+                                                const double angle, const SDL_Point& center,
+                                                const SDL_RendererFlip flip,
+                                                const SDL_Color& color) {
+	// The source is flipped inside the destination before it is rotated
+	float u1 = static_cast<float>(src.x) / textureWidth;
+	float u2 = static_cast<float>(src.x + src.w) / textureWidth;
+	float v1 = static_cast<float>(src.y) / textureHeight;
+	float v2 = static_cast<float>(src.y + src.h) / textureHeight;
+	if (flip & SDL_FLIP_HORIZONTAL) std::swap(u1, u2);
+	if (flip & SDL_FLIP_VERTICAL) std::swap(v1, v2);
+
+	// Rotating clockwise on the screen, where y points down
+	const double radians = angle * M_PI / 180;
+	const float cos = std::cos(radians);
+	const float sin = std::sin(radians);
+	const float pivotX = dest.x + center.x;
+	const float pivotY = dest.y + center.y;
+	auto corner = [&](const float x, const float y, const float u, const float v) {
+		const float dx = dest.x + x - pivotX;
+		const float dy = dest.y + y - pivotY;
+		return SDL_Vertex{SDL_FPoint{pivotX + dx * cos - dy * sin, pivotY + dx * sin + dy * cos},
+		                  color, SDL_FPoint{u, v}};
+	};
+	return {corner(0, 0, u1, v1), corner(dest.w, 0, u2, v1), corner(dest.w, dest.h, u2, v2),
+	        corner(0, dest.h, u1, v2)};
+}
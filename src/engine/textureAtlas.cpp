@@ -0,0 +1,125 @@
+#include "engine/textureAtlas.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+std::vector<TextureAtlas::Placement> TextureAtlas::pack(const std::vector<SDL_Point>& sizes,
+                                                        const int maxSize, const int padding,
+                                                        std::vector<SDL_Point>& pageSizes) {
+	pageSizes.clear();
+	std::vector<Placement> placements(sizes.size());
+
+	// Tallest first, so rows waste little height
+	std::vector<std::size_t> order(sizes.size());
+	std::iota(order.begin(), order.end(), 0);
+	std::stable_sort(order.begin(), order.end(),
+	                 [&sizes](const std::size_t a, const std::size_t b) {
+		                 return sizes[a].y > sizes[b].y;
+	                 });
+
+	// Rows about as wide as a square holding everything, but at least as wide as the widest
+	double area = 0;
+	int widest = 0;
+	for (const SDL_Point& size : sizes) {
+		if (size.x > maxSize || size.y > maxSize) continue;
+		area += static_cast<double>(size.x + padding) * (size.y + padding);
+		widest = std::max(widest, size.x);
+	}
+	const int square = std::ceil(std::sqrt(area));
+	const int width = std::min(maxSize, std::max(widest, square));
+
+	std::size_t page = 0;
+	bool pageOpen = false;
+	int x = 0, y = 0, rowHeight = 0;
+	auto openPage = [&]() {
+		page = pageSizes.size();
+		pageSizes.push_back(SDL_Point{0, 0});
+		pageOpen = true;
+		x = y = rowHeight = 0;
+	};
+	for (const std::size_t i : order) {
+		const SDL_Point& size = sizes[i];
+		if (size.x > maxSize || size.y > maxSize) {
+			// Does not fit anywhere, so it gets a page of its own
+			placements[i] = Placement{pageSizes.size(), SDL_Rect{0, 0, size.x, size.y}};
+			pageSizes.push_back(size);
+			continue;
+		}
+
+		if (!pageOpen) openPage();
+		if (x > 0 && x + size.x > width) {
+			// Next row
+			y += rowHeight + padding;
+			x = rowHeight = 0;
+		}
+		if (y + size.y > maxSize) openPage();
+
+		placements[i] = Placement{page, SDL_Rect{x, y, size.x, size.y}};
+		SDL_Point& pageSize = pageSizes[page];
+		pageSize.x = std::max(pageSize.x, x + size.x);
+		pageSize.y = std::max(pageSize.y, y + size.y);
+		x += size.x + padding;
+		rowHeight = std::max(rowHeight, size.y);
+	}
+	return placements;
+}
+
+void TextureAtlas::build(SDL_Renderer* renderer,
+                         const std::vector<std::pair<std::string, SDL_Surface*>>& images,
+                         const int maxSize) {
+	destroy();
+
+	std::vector<SDL_Point> sizes;
+	sizes.reserve(images.size());
+	for (const auto& [name, surface] : images) sizes.push_back(SDL_Point{surface->w, surface->h});
+	// One transparent pixel between images, so neighbours do not bleed into rotated sprites
+	std::vector<SDL_Point> pageSizes;
+	const std::vector<Placement> placements = pack(sizes, maxSize, 1, pageSizes);
+	pageCount = pageSizes.size();
+
+	if (renderer != nullptr) {
+		// New surfaces are cleared to transparent
+		std::vector<SDL_Surface*> pageSurfaces;
+		for (const SDL_Point& size : pageSizes)
+			pageSurfaces.push_back(
+			    SDL_CreateRGBSurfaceWithFormat(0, size.x, size.y, 32, SDL_PIXELFORMAT_ARGB8888));
+
+		for (std::size_t i = 0; i < images.size(); i++) {
+			SDL_Surface* page = pageSurfaces[placements[i].page];
+			if (page == nullptr) continue;
+			// Copy the alpha as it is instead of blending it with the empty page
+			SDL_SetSurfaceBlendMode(images[i].second, SDL_BLENDMODE_NONE);
+			SDL_Rect dest = placements[i].rect;
+			SDL_BlitSurface(images[i].second, nullptr, page, &dest);
+		}
+
+		for (SDL_Surface* surface : pageSurfaces) {
+			SDL_Texture* texture = nullptr;
+			if (surface != nullptr) {
+				texture = SDL_CreateTextureFromSurface(renderer, surface);
+				SDL_SetTextureBlendMode(texture, SDL_BLENDMODE_BLEND);
+				SDL_FreeSurface(surface);
+			}
+			pages.push_back(texture);
+		}
+	}
+
+	for (std::size_t i = 0; i < images.size(); i++) {
+		SDL_Texture* texture = pages.empty() ? nullptr : pages[placements[i].page];
+		regions[images[i].first] = Region{texture, placements[i].rect};
+	}
+}
+
+void TextureAtlas::destroy() {
+	for (SDL_Texture* page : pages)
+		if (page != nullptr) SDL_DestroyTexture(page);
+	pages.clear();
+	pageCount = 0;
+	regions.clear();
+}
+
+const TextureAtlas::Region* TextureAtlas::find(const std::string_view name) const {
+	const auto it = regions.find(name);
+	return it == regions.end() ? nullptr : &it->second;
+}
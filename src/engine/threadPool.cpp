@@ -0,0 +1,72 @@
+#include "engine/threadPool.h"
+
+#include <algorithm>
+#include <atomic>
+
+ThreadPool::ThreadPool(const std::size_t threadCount) : stopping{false} {
+	const std::size_t count =
+	    threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+
+	workers.reserve(count);
+	for (std::size_t i = 0; i < count; i++) workers.emplace_back(&ThreadPool::workerLoop, this);
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard lock{mutex};
+		stopping = true;
+	}
+	condition.notify_all();
+	for (std::thread& worker : workers) worker.join();
+}
+
+void ThreadPool::parallelFor(const std::size_t count,
+                             const std::function<void(std::size_t)>& func) {
+	if (count == 0) return;
+
+	// Shared so that helpers starting after everything is done can still check the index safely
+	struct State {
+		std::atomic<std::size_t> next{0};
+		std::size_t done = 0;
+		std::mutex mutex;
+		std::condition_variable condition;
+	};
+	auto state = std::make_shared<State>();
+	const std::function<void(std::size_t)>* funcPtr = &func;
+
+	auto work = [state, funcPtr, count] {
+		std::size_t finished = 0;
+		for (std::size_t i = state->next++; i < count; i = state->next++) {
+			(*funcPtr)(i);
+			finished++;
+		}
+		if (finished == 0) return;  // Never touched func, nothing to report
+
+		std::lock_guard lock{state->mutex};
+		state->done += finished;
+		if (state->done == count) state->condition.notify_all();
+	};
+
+	// The calling thread takes part, so one less helper is needed
+	const std::size_t helpers = std::min(workers.size(), count - 1);
+	for (std::size_t i = 0; i < helpers; i++) submit(work);
+	work();
+
+	std::unique_lock lock{state->mutex};
+	state->condition.wait(lock, [&state, count] { return state->done == count; });
+}
+
+void ThreadPool::workerLoop() {
+	while (true) {
+		std::function<void()> task;
+		{
+			std::unique_lock lock{mutex};
+			condition.wait(lock, [this] { return stopping || !tasks.empty(); });
+			if (stopping && tasks.empty()) return;
+
+			task = std::move(tasks.front());
+			tasks.pop();
+		}
+		task();
+	}
+}
@@ -8,6 +8,8 @@ int main(int argc, char** argv) {
 #endif
 
 	Game game("Cool Game", 480 * 3, 280 * 3);  // Create Game instance
+	// Draw the world at native art resolution, greatly reduces fill rate
+	game.setRenderMode(Game::RenderMode::LOW_RESOLUTION);
 
 	// Game loop
 	while (game.running()) {
@@ -69,15 +69,17 @@ void Player::update(Scene& scene, const float deltaTime) {
 
 	healthbarBG.update();
 
-	int windowHeight;
-	SDL_GetWindowSizeInPixels(scene.getGame().getWindow(), NULL, &windowHeight);
+	// Without a window, like in headless runs, the requested size is used
+	int windowHeight = scene.getGame().getWinDimensions().y;
+	if (SDL_Window* window = scene.getGame().getWindow())
+		SDL_GetWindowSizeInPixels(window, NULL, &windowHeight);
 	// Make space from bottom of screen to healthbar same as side of screen to healthbar
 	healthbarBG.localPosition.y =
 	    windowHeight - healthbarBG.localSize.y - healthbarBG.localPosition.x;
 	healthbarBG.calculatePosition();
 
-	// Tell UIManager to render healthbar
-	scene.getGame().getRenderManager().addRenderCall(healthbarBG.getRenderFunction(), this);
+	// Tell RenderManager to render healthbar
+	scene.getGame().getRenderManager().addWidget(healthbarBG, this, RenderManager::uiLayer);
 }
 
 // Points player towards the mouse
@@ -1,15 +1,27 @@
 #include "scenes/combat_scene.h"
 
+#include <cstdint>
 #include <ctime>
 #include <iostream>
+#include <optional>
 
 #include "SDL2/SDL_mouse.h"
 #include "terrain/chunk.h"
 #include "terrain/terrain.h"
 #include "terrain/terrainGenerator.h"
+#include "terrain/worldBake.h"
 
-CombatScene::CombatScene(Game& game)
-    : Scene{game}, enemyManager{}, chunkManager{generateTerrain()}, player{spawnPlayer()} {}
+CombatScene::CombatScene(Game& game, LoadingProgress* progress)
+    : Scene{game}, enemyManager{}, chunkManager{generateTerrain()}, player{nullptr} {
+	chunkManager.preloadAround(chunkManager.getWorldCenter(), progress);
+}
+
+void CombatScene::initialize() {
+	Scene::initialize();
+
+	player = &spawnPlayer();
+	std::cout << "Loaded " << chunkManager.getLoadTimings() << std::endl;
+}
 
 void CombatScene::update(const float deltaTime) {
 	if (getGame().getOnMouseDown()[SDL_BUTTON_RIGHT]) {
@@ -19,7 +31,11 @@ void CombatScene::update(const float deltaTime) {
 
 	Scene::update(deltaTime);
 
-	chunkManager.update(deltaTime, player.getPosition());
+	// Keeps positions around the player small, see ChunkManager::recenterOrigin
+	const Vec2 offset = chunkManager.recenterOrigin(player->getPosition());
+	if (offset.x != 0 || offset.y != 0) shiftOrigin(offset);
+
+	chunkManager.update(deltaTime, player->getPosition());
 
 	Scene::updateCollision();
 	chunkManager.collisionUpdate();
@@ -33,8 +49,7 @@ void CombatScene::render(SDL_Renderer* renderer) const {
 	chunkManager.render(renderer, getCam());
 }
 
-ChunkManager CombatScene::generateTerrain() {
-	TerrainGenerator gen{game.randGen};
+void CombatScene::setGeneratorParameters(TerrainGenerator& gen) {
 	// Shape parameters
 	gen.shapeFillProb = 0.2;
 	gen.shapeGenerations = 5;
@@ -58,23 +73,28 @@ ChunkManager CombatScene::generateTerrain() {
 	gen.detailsCalcMinFill = 8;
 
 	gen.edgeThickness = 100;
+}
+
+ChunkManager CombatScene::generateTerrain() {
+	TerrainGenerator gen{game.randGen};
+	setGeneratorParameters(gen);
 
-	game.randGen.seed(std::random_device{}());
-	constexpr std::size_t terrainXSize = 500;
-	constexpr std::size_t terrainYSize = 500;
-	constexpr std::size_t shapeSize = 10;
-	Terrain terrain = gen.generateTerrain(terrainXSize, terrainYSize, shapeSize);
+	// A baked world is used with the seed it was baked with
+	std::optional<WorldBake> bake = WorldBake::open(bakePath);
+	const std::uint32_t seed = bake ? bake->getHeader().seed : std::random_device{}();
+	game.randGen.seed(seed);
 
-	constexpr std::size_t chunkSize = 100;
 	constexpr int pixelSizeMultiplier = 3;
 	constexpr SDL_Color terrainColor{56, 28, 40, 255};
-	ChunkManager manager{terrain,      chunkSize, pixelSizeMultiplier,
-	                     terrainColor, *this,     enemyManager};
+	ChunkManager manager{gen,          seed,         shapeSize,           worldChunksX,
+	                     worldChunksY, chunkSize,    pixelSizeMultiplier, terrainColor,
+	                     *this,        enemyManager, std::move(bake)};
 	return manager;
 }
 
 const Player& CombatScene::spawnPlayer() {
-	const auto spawns = chunkManager.getAllSpawns();
+	// Only the chunks around the start are generated yet
+	const auto spawns = chunkManager.getSpawnsAround(chunkManager.getWorldCenter());
 	std::uniform_int_distribution<std::size_t> dist{0, spawns.size() - 1};
 	const std::size_t idx = dist(game.randGen);
 	const Vec2 spawnPos = spawns[idx];
@@ -0,0 +1,26 @@
+#include "scenes/loading_scene.h"
+
+#include "engine/game.h"
+
+namespace {
+const Vec2 barSize{600, 30};
+}
+
+LoadingScene::LoadingScene(Game& game)
+    : Scene{game},
+      progressBG{(game.getWinDimensions() - barSize) * 0.5f, barSize, SDL_Color{30, 15, 22, 255}} {
+	progressSlider = new UI::Slider(SDL_Color{200, 170, 120, 255}, &progressBG);
+	progressSlider->setValue(0);
+}
+
+void LoadingScene::update(const float deltaTime) {
+	Scene::update(deltaTime);
+
+	progressSlider->setValue(game.getLoadingProgress().get() * 100);
+}
+
+void LoadingScene::render(SDL_Renderer* renderer) const {
+	Scene::render(renderer);
+
+	progressBG.render(renderer);
+}
@@ -1,38 +1,112 @@
 #include "terrain/chunk.h"
 
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <cmath>
+#include <mutex>
+#include <numeric>
+#include <tuple>
 
 #include "engine/camera.h"
+#include "engine/game.h"
+#include "engine/scene.h"
+#include "engine/threadPool.h"
+#include "engine/timing.h"
 #include "terrain/chunkManager.h"
 #include "terrain/terrainCollider.h"
+#include "terrain/terrainShapes.h"
 
-std::array<int, Chunk::minSpawnSpace> Chunk::spawnCircleY = [] {
-	std::array<int, minSpawnSpace> result;
-	for (int x = 0; x < minSpawnSpace; x++) {
-		result[x] =
-		    std::round(std::sin(std::acos(static_cast<double>(x) / minSpawnSpace)) * minSpawnSpace);
+namespace {
+Chunk::Segment toSegment(const std::pair<int, int>& start, const std::pair<int, int>& end) {
+	return Chunk::Segment{
+	    static_cast<std::uint16_t>(start.first), static_cast<std::uint16_t>(start.second),
+	    static_cast<std::uint16_t>(end.first), static_cast<std::uint16_t>(end.second)};
+}
+
+/* What scan finds for a uniform terrain of the given size and value, found once for every size.
+ * Called from worker threads.
+ */
+template <class T, class Scan>
+const std::vector<T>& uniformResult(const std::size_t xSize, const std::size_t ySize,
+                                    const unsigned char value, Scan scan) {
+	static std::mutex mutex;
+	static std::map<std::tuple<std::size_t, std::size_t, unsigned char>, std::vector<T>> results;
+
+	std::lock_guard lock{mutex};
+	const auto key = std::make_tuple(xSize, ySize, value);
+	auto it = results.find(key);
+	if (it == results.end()) {
+		Terrain terrain{xSize, ySize};
+		for (auto& row : terrain.map) std::fill(row.begin(), row.end(), value);
+		it = results.emplace(key, scan(terrain)).first;
 	}
-	return result;
-}();
+	return it->second;
+}
+}  // namespace
 
-Chunk::Chunk(std::vector<std::vector<unsigned char>>&& map, const std::size_t originX,
-             const std::size_t originY, ChunkManager& manager, EnemyManager& enemyManager)
+Chunk::Chunk(std::vector<std::vector<unsigned char>>&& map, const float originX,
+             const float originY, ChunkManager& manager, EnemyManager& enemyManager,
+             BuildTimings* timings)
     : state{},
       manager{manager},
-      terrain{std::move(map)},
+      terrain{std::make_shared<Terrain>(std::move(map))},
       originX{originX},
       originY{originY},
+      rowFilled{countRows(*terrain)},
+      regions{*terrain},
+      residency{Residency::FULL},
       renderRects{},
       colliders{},
+      rebuildQueued{false},
       enemySpawner{enemyManager} {
-	renderRects.resize(terrain.getYSize(), std::vector<SDL_Rect>(terrain.getXSize()));
-	updateColliders();
-	updateSpawnPositions();
-	updateRender(manager.getPixelSize());
+	Timing::timed(timings ? &timings->colliders : nullptr, [this] { updateColliders(); });
+	Timing::timed(timings ? &timings->spawns : nullptr, [this] { updateSpawnPositions(); });
+	Timing::timed(timings ? &timings->render : nullptr,
+	      [this, &manager] { updateRender(manager.getPixelSize()); });
+}
+
+Chunk::Chunk(std::vector<std::vector<unsigned char>>&& map, const float originX,
+             const float originY, ChunkManager& manager, EnemyManager& enemyManager,
+             const std::span<const Segment> segments, BuildTimings* timings)
+    : state{},
+      manager{manager},
+      terrain{std::make_shared<Terrain>(std::move(map))},
+      originX{originX},
+      originY{originY},
+      rowFilled{countRows(*terrain)},
+      regions{*terrain},
+      residency{Residency::FULL},
+      renderRects{},
+      colliders{},
+      rebuildQueued{false},
+      enemySpawner{enemyManager} {
+	Timing::timed(timings ? &timings->colliders : nullptr, [&] {
+		colliders = buildColliders(segments, originX, originY, manager.getPixelSize(), *this);
+	});
+	Timing::timed(timings ? &timings->spawns : nullptr, [this] { updateSpawnPositions(); });
+	Timing::timed(timings ? &timings->render : nullptr,
+	      [this, &manager] { updateRender(manager.getPixelSize()); });
+}
+
+Chunk::BuildTimings& Chunk::BuildTimings::operator+=(const BuildTimings& other) {
+	colliders += other.colliders;
+	spawns += other.spawns;
+	render += other.render;
+	return *this;
 }
 
 void Chunk::update(Scene& scene, const float deltaTime) {
-	if (state == EDGE) enemySpawner.update(scene, deltaTime);
+	if (state == EDGE) {
+		enemySpawner.update(scene, deltaTime, [this](std::mt19937& randGen) {
+			// Enemies in pockets the player can not be reached from would never get to attack
+			for (int i = 0; i < spawnTries; i++) {
+				const std::optional<Vec2> pos = sampleSpawnPosition(randGen);
+				if (!pos || manager.isConnectedToPlayer(*pos)) return pos;
+			}
+			return std::optional<Vec2>{};
+		});
+	}
 	for (TerrainCollider& collider : colliders) collider.update(scene);
 }
 
@@ -41,73 +115,305 @@ void Chunk::collisionUpdate(Scene& scene) {
 }
 
 void Chunk::changeTerrain(const TerrainChange& change) {
-	assert(change.x >= 0 && change.x < terrain.getXSize() && change.y >= 0 &&
-	       change.y < terrain.getYSize() && "Position (x, y) must be within the terrain size.");
+	const TerrainSpan span{change.y, change.x, change.x + 1, change.value};
+	changeTerrainSpans(std::span{&span, 1});
+}
+
+void Chunk::changeTerrainSpans(const std::span<const TerrainSpan> spans) {
+	Terrain& writable = getWritableTerrain();
+	std::size_t minX = writable.getXSize(), maxX = 0;
+	bool filled = false;
+	std::vector<std::pair<std::size_t, std::size_t>> opened;
+	for (const auto [y, x1, x2, value] : spans) {
+		assert(x1 < x2 && x2 <= writable.getXSize() && y < writable.getYSize() &&
+		       "Span must be within the terrain size.");
+		const auto row = writable.map[y].begin();
+		const std::size_t before = std::count_if(row + x1, row + x2, [](unsigned char cell) {
+			return cell != 0;
+		});
+		// Keep rowFilled up to date
+		if (value) {
+			filled |= before < x2 - x1;
+			rowFilled[y] += x2 - x1 - before;
+		} else {
+			for (std::size_t x = x1; before != 0 && x < x2; x++)
+				if (row[x]) opened.emplace_back(x, y);
+			rowFilled[y] -= before;
+		}
+		std::fill(row + x1, row + x2, value);
 
-	terrain.map[change.y][change.x] = change.value;
+		minX = std::min(minX, x1);
+		maxX = std::max(maxX, x2 - 1);
+	}
+	// Only around the changed cells
+	if (residency == Residency::FULL && !spans.empty())
+		spawnMap.update(writable, minX, maxX);
+	// Opening cells only joins regions, filling them can split one
+	if (filled)
+		regions = RegionLabels{writable};
+	else if (!opened.empty())
+		regions.open(writable, opened);
+
+	startRebuild();
+}
 
-	updateColliders();
-	updateRender(manager.getPixelSize());
+void Chunk::startRebuild() {
+	if (pendingBuild.valid()) {
+		rebuildQueued = true;
+		return;
+	}
+	if (residency == Residency::COMPACT) return;
+	startBuild(false);
+}
+
+void Chunk::startBuild(const bool findSpawns) {
+	// The worker keeps the snapshot alive, and edits made meanwhile go to a copy
+	std::shared_ptr<const Terrain> snapshot = terrain;
+	const int pixelSize = manager.getPixelSize();
+	pendingBuild = manager.getScene().getGame().getThreadPool().submit(
+	    [snapshot, rows = rowFilled, originX = originX, originY = originY, pixelSize, findSpawns,
+	     this]() mutable {
+		    const Fill fill = findFill(rows, snapshot->getXSize());
+		    const std::vector<Segment> segments = findSegments(*snapshot, fill);
+		    Build build{buildColliders(segments, originX, originY, pixelSize, *this),
+		                buildRenderRects(*snapshot, rows, originX, originY, pixelSize),
+		                std::move(rows), std::nullopt, originX, originY};
+		    if (findSpawns) build.spawnMap = SpawnMap{*snapshot};
+		    return build;
+	    });
+}
+
+bool Chunk::finishRebuild() {
+	if (!pendingBuild.valid() ||
+	    pendingBuild.wait_for(std::chrono::seconds{0}) != std::future_status::ready)
+		return false;
+
+	Build build = pendingBuild.get();
+	if (residency == Residency::COMPACT) {
+		// Dropped while building, built again from the latest terrain when needed
+		rebuildQueued = false;
+		return false;
+	}
+	colliders = std::move(build.colliders);
+	renderRects = std::move(build.renderRects);
+	renderRowFilled = std::move(build.renderRowFilled);
+	// The origin was moved while building
+	if (build.originX != originX || build.originY != originY)
+		shiftCaches(Vec2{originX - build.originX, originY - build.originY});
+	if (build.spawnMap) {
+		// Edits made while building have not been applied to it
+		spawnMap = rebuildQueued ? SpawnMap{*terrain} : std::move(*build.spawnMap);
+	}
+	residency = Residency::FULL;
+
+	if (rebuildQueued) {
+		rebuildQueued = false;
+		startRebuild();
+	}
+	return true;
+}
+
+void Chunk::shiftOrigin(const Vec2& offset) {
+	originX += offset.x;
+	originY += offset.y;
+	shiftCaches(offset);
 }
 
-void Chunk::changeTerrainMultiple(const std::vector<TerrainChange>& changes) {
-	for (auto [x, y, value] : changes) {
-		assert(x >= 0 && x < terrain.getXSize() && y >= 0 && y < terrain.getYSize() &&
-		       "Position (x, y) must be within the terrain size.");
-		terrain.map[y][x] = value;
+void Chunk::shiftCaches(const Vec2& offset) {
+	for (TerrainCollider& collider : colliders) collider.shift(offset);
+
+	// Offsets are whole cells, so the rectangles stay on integer positions
+	const int x = std::lround(offset.x);
+	const int y = std::lround(offset.y);
+	for (std::vector<SDL_Rect>& row : renderRects) {
+		for (SDL_Rect& rect : row) {
+			rect.x += x;
+			rect.y += y;
+		}
 	}
+}
 
+void Chunk::makeCompact() {
+	if (residency == Residency::COMPACT) return;
+	residency = Residency::COMPACT;
+
+	// Assign new vectors, clearing would keep the memory
+	colliders = std::vector<TerrainCollider>{};
+	renderRects = std::vector<std::vector<SDL_Rect>>{};
+	renderRowFilled = std::vector<std::uint16_t>{};
+	spawnMap = SpawnMap{};
+}
+
+void Chunk::prefetch() {
+	if (residency != Residency::COMPACT) return;
+	/* A rebuild started before the chunk was dropped would be out of date. Dropping the future
+	 * ignores its result without waiting for the worker, which only reads its own snapshot.
+	 */
+	pendingBuild = {};
+	rebuildQueued = false;
+
+	residency = Residency::LOADING;
+	startBuild(true);
+}
+
+void Chunk::makeResident() {
+	if (residency == Residency::FULL) return;
+	if (residency == Residency::LOADING) {
+		// Blocks on purpose, the colliders have to exist before the player can reach the chunk
+		pendingBuild.wait();
+		finishRebuild();
+		return;
+	}
+
+	// Out of date like in prefetch, the chunk is built from the latest terrain below
+	pendingBuild = {};
+	rebuildQueued = false;
+
+	residency = Residency::FULL;
 	updateColliders();
+	updateSpawnPositions();
 	updateRender(manager.getPixelSize());
 }
 
-void Chunk::render(SDL_Renderer* renderer, const Camera& cam) const {
+Terrain& Chunk::getWritableTerrain() {
+	if (terrain.use_count() > 1) terrain = std::make_shared<Terrain>(*terrain);
+	return *terrain;
+}
+
+void Chunk::render(SDL_Renderer* renderer, const Camera& cam, const Vec2& viewSize) const {
+	const Vec2& camPos = cam.getPos();
+	const float pixelSize = manager.getPixelSize();
+
+	// Clip to the rows and columns of this chunk that overlap the view
+	const long startX =
+	    std::max(0L, static_cast<long>(std::floor((camPos.x - originX) / pixelSize)));
+	const long startY =
+	    std::max(0L, static_cast<long>(std::floor((camPos.y - originY) / pixelSize)));
+	const long endX =
+	    std::min(static_cast<long>(terrain->getXSize()),
+	             static_cast<long>(std::ceil((camPos.x + viewSize.x - originX) / pixelSize)));
+	const long endY =
+	    std::min(static_cast<long>(terrain->getYSize()),
+	             static_cast<long>(std::ceil((camPos.y + viewSize.y - originY) / pixelSize)));
+	if (startX >= endX || startY >= endY) return;  // Chunk is outside the view
+
 	std::vector<SDL_Rect> rects;
-	rects.reserve(terrain.getXSize() * terrain.getYSize());
-	for (auto curRects : renderRects) {
-		for (auto& rect : curRects) {
-			const Vec2& camPos = cam.getPos();
+	// Consecutive completely filled rows are rendered as one rectangle
+	long fullStartY = -1;
+	auto endFullRows = [&](const long y) {
+		if (fullStartY < 0) return;
+		rects.push_back(SDL_Rect{static_cast<int>(originX + startX * pixelSize - camPos.x),
+		                         static_cast<int>(originY + fullStartY * pixelSize - camPos.y),
+		                         static_cast<int>((endX - startX) * pixelSize),
+		                         static_cast<int>((y - fullStartY) * pixelSize)});
+		fullStartY = -1;
+	};
+
+	const std::size_t xSize = terrain->getXSize();
+	for (long y = startY; y < endY; y++) {
+		if (renderRowFilled[y] == xSize) {
+			if (fullStartY < 0) fullStartY = y;
+			continue;
+		}
+		endFullRows(y);
+		if (renderRowFilled[y] == 0) continue;
+
+		for (long x = startX; x < endX; x++) {
+			SDL_Rect rect = renderRects[y][x];
+			if (rect.w == 0) continue;  // Empty cell
 			rect.x -= camPos.x;
 			rect.y -= camPos.y;
+			rects.push_back(rect);
 		}
-		rects.insert(rects.end(), curRects.begin(), curRects.end());
 	}
-	SDL_RenderFillRects(renderer, &rects[0], rects.size());
+	endFullRows(endY);
+	if (!rects.empty()) SDL_RenderFillRects(renderer, rects.data(), rects.size());
 }
 
 void Chunk::updateRender(const int pixelSize) {
-	for (std::size_t x = 0; x < terrain.getXSize(); x++) {
-		for (std::size_t y = 0; y < terrain.getYSize(); y++) {
-			if (terrain.map[y][x]) {
-				if (renderRects[y][x].w == pixelSize) continue;  // Already calculated
-
-				renderRects[y][x].x = x * pixelSize + originX;
-				renderRects[y][x].y = y * pixelSize + originY;
-				renderRects[y][x].w = renderRects[y][x].h = pixelSize;
-			} else {
-				// Set width and height to 0 so that it is not rendered
-				renderRects[y][x].w = renderRects[y][x].h = 0;
-			}
+	if (residency != Residency::FULL) return;
+	renderRects = buildRenderRects(*terrain, rowFilled, originX, originY, pixelSize);
+	renderRowFilled = rowFilled;
+}
+
+std::vector<std::vector<SDL_Rect>> Chunk::buildRenderRects(
+    const Terrain& terrain, const std::span<const std::uint16_t> rowFilled,
+    const float originX, const float originY, const int pixelSize) {
+	std::vector<std::vector<SDL_Rect>> result(terrain.getYSize());
+	for (std::size_t y = 0; y < terrain.getYSize(); y++) {
+		if (rowFilled[y] == 0 || rowFilled[y] == terrain.getXSize()) continue;
+
+		// Empty cells have width and height 0 so that they are not rendered
+		result[y].resize(terrain.getXSize());
+		for (std::size_t x = 0; x < terrain.getXSize(); x++) {
+			if (!terrain.map[y][x]) continue;
+
+			result[y][x].x = x * pixelSize + originX;
+			result[y][x].y = y * pixelSize + originY;
+			result[y][x].w = result[y][x].h = pixelSize;
 		}
 	}
+	return result;
 }
 
 void Chunk::updateColliders() {
-	colliders.clear();
+	if (residency != Residency::FULL) return;
+	colliders = buildColliders(findSegments(*terrain, getFill()), originX, originY,
+	                           manager.getPixelSize(), *this);
+}
 
+std::vector<TerrainCollider> Chunk::buildColliders(const std::span<const Segment> segments,
+                                                   const float originX, const float originY,
+                                                   const int pixelSize, Chunk& owner) {
+	std::vector<TerrainCollider> colliders;
+	colliders.reserve(segments.size());
+	for (const Segment& segment : segments) {
+		Vec2 start{segment.startX * pixelSize + originX, segment.startY * pixelSize + originY};
+		Vec2 end{segment.endX * pixelSize + originX, segment.endY * pixelSize + originY};
+		Vec2 position{start + (end - start) * 0.5f};
+		colliders.emplace_back(std::move(position), std::move(start), std::move(end), owner);
+	}
+	return colliders;
+}
+
+std::vector<std::uint16_t> Chunk::countRows(const Terrain& terrain) {
+	std::vector<std::uint16_t> result;
+	result.reserve(terrain.getYSize());
+	for (const auto& row : terrain.map) {
+		result.push_back(std::count_if(row.begin(), row.end(),
+		                               [](const unsigned char cell) { return cell != 0; }));
+	}
+	return result;
+}
+
+Chunk::Fill Chunk::findFill(const std::span<const std::uint16_t> rowFilled,
+                            const std::size_t xSize) {
+	const std::size_t filled = std::accumulate(rowFilled.begin(), rowFilled.end(), std::size_t{0});
+	if (filled == 0) return Fill::EMPTY;
+	if (filled == xSize * rowFilled.size()) return Fill::SOLID;
+	return Fill::MIXED;
+}
+
+std::vector<Chunk::Segment> Chunk::findSegments(const Terrain& terrain, const Fill fill) {
+	if (fill == Fill::EMPTY) return {};
+	if (fill == Fill::SOLID)
+		return uniformResult<Segment>(terrain.getXSize(), terrain.getYSize(), 1, scanSegments);
+	return scanSegments(terrain);
+}
+
+std::vector<Chunk::Segment> Chunk::scanSegments(const Terrain& terrain) {
+	std::vector<Segment> segments;
 	std::map<std::pair<int, int>, std::pair<int, int>> currentColliders;  // Key: end, Value: start
 
-	for (std::size_t x = 0; x < terrain.getXSize(); ++x) {
-		const float xPos = x * manager.getPixelSize() + originX;
-		for (std::size_t y = 0; y < terrain.getYSize(); ++y) {
+	// Positions are cell corners, scaled to pixels when the colliders are built
+	for (int x = 0; x < terrain.getXSize(); ++x) {
+		for (int y = 0; y < terrain.getYSize(); ++y) {
 			if (!terrain.map[y][x]) continue;
 
-			const std::size_t yPos = y * manager.getPixelSize() + originY;
-			const std::pair<int, int> topLeft{xPos, yPos};
-			const std::pair<int, int> topRight{xPos + manager.getPixelSize(), yPos};
-			const std::pair<int, int> botLeft{xPos, yPos + manager.getPixelSize()};
-			const std::pair<int, int> botRight{xPos + manager.getPixelSize(),
-			                                   yPos + manager.getPixelSize()};
+			const std::pair<int, int> topLeft{x, y};
+			const std::pair<int, int> topRight{x + 1, y};
+			const std::pair<int, int> botLeft{x, y + 1};
+			const std::pair<int, int> botRight{x + 1, y + 1};
 
 			const bool left = x > 0 && terrain.map[y][x - 1];
 			const bool right = x < terrain.getXSize() - 1 && terrain.map[y][x + 1];
@@ -118,76 +424,77 @@ void Chunk::updateColliders() {
 				continue;  // Terrain in all directions
 			else if (!left && right && above && below) {
 				// Only empty to the left
-				tryExtendCollider(topLeft, botLeft, currentColliders);
+				tryExtendCollider(topLeft, botLeft, currentColliders, segments);
 			} else if (left && !right && above && below) {
 				// Only empty to the right
-				tryExtendCollider(topRight, botRight, currentColliders);
+				tryExtendCollider(topRight, botRight, currentColliders, segments);
 			} else if (left && right && !above && below) {
 				// Only empty above
-				tryExtendCollider(topLeft, topRight, currentColliders);
+				tryExtendCollider(topLeft, topRight, currentColliders, segments);
 			} else if (left && right && above && !below) {
 				// Only empty below
-				tryExtendCollider(botLeft, botRight, currentColliders);
+				tryExtendCollider(botLeft, botRight, currentColliders, segments);
 			} else if (!left && !right && above && below) {
 				// Straight vertical line
-				tryExtendCollider(topLeft, botLeft, currentColliders);
-				tryExtendCollider(topRight, botRight, currentColliders);
+				tryExtendCollider(topLeft, botLeft, currentColliders, segments);
+				tryExtendCollider(topRight, botRight, currentColliders, segments);
 			} else if ((!left && right && !above && below) || (left && !right && above && !below)) {
 				// Diagonal line from bottom left to top right
-				tryExtendCollider(botLeft, topRight, currentColliders);
+				tryExtendCollider(botLeft, topRight, currentColliders, segments);
 			} else if ((!left && right && above && !below) || (left && !right && !above && below)) {
 				// Diagonal from top left to bottom right
-				tryExtendCollider(topLeft, botRight, currentColliders);
+				tryExtendCollider(topLeft, botRight, currentColliders, segments);
 			} else if (left && right && !above && !below) {
 				// Straight horizontal line
-				tryExtendCollider(topLeft, topRight, currentColliders);
-				tryExtendCollider(botLeft, botRight, currentColliders);
+				tryExtendCollider(topLeft, topRight, currentColliders, segments);
+				tryExtendCollider(botLeft, botRight, currentColliders, segments);
 			} else if (!left && !right && !above && below) {
 				// Three lines, vertical left, horizontal above, and vertical right
-				tryExtendCollider(topLeft, botLeft, currentColliders);
-				tryExtendCollider(topLeft, topRight, currentColliders);
-				tryExtendCollider(topRight, botRight, currentColliders);
+				tryExtendCollider(topLeft, botLeft, currentColliders, segments);
+				tryExtendCollider(topLeft, topRight, currentColliders, segments);
+				tryExtendCollider(topRight, botRight, currentColliders, segments);
 			} else if (!left && !right && above && !below) {
 				// Three line, vertical left, vertical right, and horizontal below
-				tryExtendCollider(topLeft, botLeft, currentColliders);
-				tryExtendCollider(topRight, botRight, currentColliders);
-				tryExtendCollider(botLeft, botRight, currentColliders);
+				tryExtendCollider(topLeft, botLeft, currentColliders, segments);
+				tryExtendCollider(topRight, botRight, currentColliders, segments);
+				tryExtendCollider(botLeft, botRight, currentColliders, segments);
 			} else if (!left && right && !above && !below) {
 				// Three lines, vertical left, horizontal above, and horizontal below
-				tryExtendCollider(topLeft, botLeft, currentColliders);
-				tryExtendCollider(topLeft, topRight, currentColliders);
-				tryExtendCollider(botLeft, botRight, currentColliders);
+				tryExtendCollider(topLeft, botLeft, currentColliders, segments);
+				tryExtendCollider(topLeft, topRight, currentColliders, segments);
+				tryExtendCollider(botLeft, botRight, currentColliders, segments);
 			} else if (left && !right && !above && !below) {
 				// Three lines, vertical right, horizontal above, and horizontal below
-				tryExtendCollider(topRight, botRight, currentColliders);
-				tryExtendCollider(topLeft, topRight, currentColliders);
-				tryExtendCollider(botLeft, botRight, currentColliders);
+				tryExtendCollider(topRight, botRight, currentColliders, segments);
+				tryExtendCollider(topLeft, topRight, currentColliders, segments);
+				tryExtendCollider(botLeft, botRight, currentColliders, segments);
 			} else if (!left && !right && !above && !below) {
 				// Colliders on every side
-				tryExtendCollider(topLeft, botLeft, currentColliders);
-				tryExtendCollider(topRight, botRight, currentColliders);
-				tryExtendCollider(topLeft, topRight, currentColliders);
-				tryExtendCollider(botLeft, botRight, currentColliders);
+				tryExtendCollider(topLeft, botLeft, currentColliders, segments);
+				tryExtendCollider(topRight, botRight, currentColliders, segments);
+				tryExtendCollider(topLeft, topRight, currentColliders, segments);
+				tryExtendCollider(botLeft, botRight, currentColliders, segments);
 			}
 		}
 	}
 
-	// Construct colliders
-	colliders.reserve(colliders.size() + currentColliders.size());
-	for (const auto& [end, start] : currentColliders)
-		createCollider(Vec2{start.first, start.second}, Vec2{end.first, end.second});
+	// Add the lines that were still being extended
+	segments.reserve(segments.size() + currentColliders.size());
+	for (const auto& [end, start] : currentColliders) segments.push_back(toSegment(start, end));
+	return segments;
 }
 
 void Chunk::tryExtendCollider(
     const std::pair<int, int>& start, const std::pair<int, int>& end,
-    std::map<std::pair<int, int>, std::pair<int, int>>& currentColliders) {
+    std::map<std::pair<int, int>, std::pair<int, int>>& currentColliders,
+    std::vector<Segment>& segments) {
 	const Vec2 startVec{start.first, start.second};
-	Vec2 endVec{end.first, end.second};
+	const Vec2 endVec{end.first, end.second};
 
 	// Create collider if there already is one ending at end
 	auto endIt = currentColliders.find(end);
 	if (endIt != currentColliders.end()) {
-		createCollider(Vec2{endIt->second.first, endIt->second.second}, std::move(endVec));
+		segments.push_back(toSegment(endIt->second, end));
 		currentColliders.erase(endIt);
 	}
 
@@ -207,19 +514,46 @@ void Chunk::tryExtendCollider(
 	currentColliders[end] = start;
 }
 
-void Chunk::createCollider(Vec2&& start, Vec2&& end) {
-	Vec2 position{start + (end - start) * 0.5f};
-	colliders.emplace_back(std::move(position), std::move(start), std::move(end), *this);
+void Chunk::updateSpawnPositions() {
+	if (residency != Residency::FULL) return;
+	spawnMap = SpawnMap{*terrain};
 }
 
-void Chunk::updateSpawnPositions() { enemySpawner.updateSpawnPositions(findSpawnPositions()); }
+std::optional<Vec2> Chunk::sampleSpawnPosition(std::mt19937& randGen) const {
+	const auto cell = spawnMap.sample(randGen);
+	if (!cell) return std::nullopt;
+	return Vec2{cell->first * manager.getPixelSize() + originX,
+	            cell->second * manager.getPixelSize() + originY};
+}
 
 std::vector<Vec2> Chunk::findSpawnPositions() const {
+	return toSpawnPositions(findSpawnCells(*terrain, getFill()));
+}
+
+std::vector<Vec2> Chunk::toSpawnPositions(const std::span<const SpawnCell> cells) const {
 	std::vector<Vec2> positions;
+	positions.reserve(cells.size());
+	for (const auto [x, y] : cells) {
+		positions.emplace_back(x * manager.getPixelSize() + originX,
+		                       y * manager.getPixelSize() + originY);
+	}
+	return positions;
+}
+
+std::vector<Chunk::SpawnCell> Chunk::findSpawnCells(const Terrain& terrain, const Fill fill) {
+	if (fill == Fill::SOLID) return {};
+	if (fill == Fill::EMPTY)
+		return uniformResult<SpawnCell>(terrain.getXSize(), terrain.getYSize(), 0, scanSpawnCells);
+	return scanSpawnCells(terrain);
+}
+
+std::vector<Chunk::SpawnCell> Chunk::scanSpawnCells(const Terrain& terrain) {
+	std::vector<SpawnCell> cells;
 
 	Terrain used{terrain.map};
-	for (std::size_t y = minSpawnSpace; y < terrain.getYSize() - minSpawnSpace; y++) {
-		for (std::size_t x = minSpawnSpace; x < terrain.getXSize() - minSpawnSpace; x++) {
+	// Written so the bounds do not wrap around for chunks smaller than the spawn area
+	for (std::size_t y = minSpawnSpace; y + minSpawnSpace < used.getYSize(); y++) {
+		for (std::size_t x = minSpawnSpace; x + minSpawnSpace < used.getXSize(); x++) {
 			auto result = findObstruction(x, y, used);
 			if (result.has_value()) {
 				// Move just enough to the right to avoid whatever we encountered.
@@ -227,16 +561,16 @@ std::vector<Vec2> Chunk::findSpawnPositions() const {
 				// hitX + minSpawnSpace moves so that the entire area is outside,
 				// the y stuff moves back proportional to how high up we hit.
 				x = hitX + minSpawnSpace - (std::max(hitY, y) - std::min(hitY, y)) +
-				    spawnCircleY.back() + 1;
+				    SpawnMap::circleY.back() + 1;
 			} else {
-				positions.emplace_back(x * manager.getPixelSize() + originX,
-				                       y * manager.getPixelSize() + originY);
+				cells.push_back(SpawnCell{static_cast<std::uint16_t>(x),
+				                          static_cast<std::uint16_t>(y)});
 
 				// Set all positions inside the spawn area as used.
-				const int cornerDist = spawnCircleY.back() - 1;
+				const int cornerDist = SpawnMap::circleY.back() - 1;
 				for (int xAdd = -minSpawnSpace + 1; xAdd < minSpawnSpace; xAdd++) {
-					for (int yAdd = -spawnCircleY[std::abs(xAdd)];
-					     yAdd < spawnCircleY[std::abs(xAdd)]; yAdd++) {
+					for (int yAdd = -SpawnMap::circleY[std::abs(xAdd)];
+					     yAdd < SpawnMap::circleY[std::abs(xAdd)]; yAdd++) {
 						used.map[y + yAdd][x + xAdd] = 1;
 					}
 				}
@@ -246,11 +580,11 @@ std::vector<Vec2> Chunk::findSpawnPositions() const {
 		}
 	}
 
-	return positions;
+	return cells;
 }
 
 std::optional<std::pair<std::size_t, std::size_t>> Chunk::findObstruction(
-    const std::size_t cx, const std::size_t cy, const Terrain& used) const {
+    const std::size_t cx, const std::size_t cy, const Terrain& used) {
 	assert(cx - minSpawnSpace >= 0 && cx + minSpawnSpace < used.getXSize() &&
 	       cy - minSpawnSpace >= 0 && cy + minSpawnSpace < used.getYSize() &&
 	       "Cannot evaluate spawn that goes outside of chunk bounds.");
@@ -258,7 +592,7 @@ std::optional<std::pair<std::size_t, std::size_t>> Chunk::findObstruction(
 	// Check from right to left, because if there is something blocking further to the right
 	// and we move to avoid something to the left, the next check will anyways be negative.
 	for (int x = minSpawnSpace - 1; x > -minSpawnSpace; x--) {
-		for (int y = spawnCircleY[std::abs(x)]; y > 0; y--) {
+		for (int y = SpawnMap::circleY[std::abs(x)]; y > 0; y--) {
 			// Check from top and bottom moving inwards.
 			if (used.map[cy - y][cx + x]) return std::make_pair(cx + x, cy - y);
 			if (used.map[cy + y][cx + x]) return std::make_pair(cx + x, cy + y);
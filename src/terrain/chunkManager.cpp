@@ -1,33 +1,90 @@
 #include "terrain/chunkManager.h"
 
 #include <cassert>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <string>
 
 #include "SDL2/SDL_render.h"
 #include "engine/game.h"
+#include "engine/loadingProgress.h"
 #include "engine/scene.h"
+#include "engine/timing.h"
 #include "terrain/chunk.h"
 #include "terrain/terrainCollider.h"
 
+namespace {
+// Scratch file for the terrain store, unique for every manager.
+std::string makeStorePath() {
+	static std::atomic<unsigned> count{0};
+	const std::string name = "terrain_" + std::to_string(std::random_device{}()) + "_" +
+	                         std::to_string(count++) + ".pages";
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+}  // namespace
+
 ChunkManager::ChunkManager(const Terrain& terrain, const std::size_t chunkSize,
                            const int pixelSizeMultiplier, const SDL_Color& color, Scene& scene,
                            EnemyManager& enemyManager)
-    : chunkSize{chunkSize},
-      pixelSize{Game::pixelSize * pixelSizeMultiplier},
-      color{color},
-      scene{scene},
+    : scene{scene},
       enemyManager{enemyManager},
-      chunks{splitToChunks(terrain, chunkSize)},
+      pixelSize{Game::pixelSize * pixelSizeMultiplier},
+      chunkSize{chunkSize},
+      chunksX{terrain.getXSize() / chunkSize},
+      chunksY{terrain.getYSize() / chunkSize},
       terrainXSize{terrain.getXSize()},
-      terrainYSize{terrain.getYSize()} {}
+      terrainYSize{terrain.getYSize()},
+      color{color} {
+	splitToChunks(terrain);
+}
+
+ChunkManager::ChunkManager(const TerrainGenerator& generator, const std::uint32_t seed,
+                           const std::size_t shapeSize, const std::size_t chunksX,
+                           const std::size_t chunksY, const std::size_t chunkSize,
+                           const int pixelSizeMultiplier, const SDL_Color& color, Scene& scene,
+                           EnemyManager& enemyManager, std::optional<WorldBake> bake)
+    : scene{scene},
+      enemyManager{enemyManager},
+      pixelSize{Game::pixelSize * pixelSizeMultiplier},
+      chunkSize{chunkSize},
+      chunksX{chunksX},
+      chunksY{chunksY},
+      terrainXSize{chunksX * chunkSize},
+      terrainYSize{chunksY * chunkSize},
+      streaming{Streaming{generator, seed, shapeSize, std::move(bake),
+                          TerrainStore{makeStorePath(), chunkSize, chunksX, chunksY,
+                                       storeResidentLimit}}},
+      color{color} {
+	std::optional<WorldBake>& loaded = streaming->bake;
+	if (loaded && loaded->getHeader().key !=
+	                  WorldBake::makeKey(generator, seed, shapeSize, chunkSize, chunksX, chunksY)) {
+		std::cout << "World bake was made for another world, generating instead.\n";
+		loaded.reset();
+	}
+}
 
 ChunkManager::~ChunkManager() = default;
 
 void ChunkManager::update(const float deltaTime, const Vec2& playerPos) {
-	if (!pendingTerrainChanges.empty()) executeTerrainChanges();
+	// Start of the frame, so nothing is using the colliders that are replaced
+	for (auto& [pos, chunk] : chunks) chunk->finishRebuild();
+	if (pendingFlowField.valid() &&
+	    pendingFlowField.wait_for(std::chrono::seconds{0}) == std::future_status::ready)
+		flowField = pendingFlowField.get();
+
+	if (!pendingTerrainSpans.empty()) executeTerrainChanges();
 
 	updateActiveChunks(playerPos, chunkRange);
+	updateFlowField(playerPos);
+	if (regionsOutdated) updateRegions();
+	playerRegion = getRegion(playerPos);
 	for (Chunk& chunk : activeChunks) chunk.update(scene, deltaTime);
 }
 
@@ -36,23 +93,26 @@ void ChunkManager::collisionUpdate() {
 }
 
 void ChunkManager::updateRender() {
-	for (auto& vec : chunks)
-		for (Chunk& chunk : vec) chunk.updateRender(pixelSize);
+	for (auto& [pos, chunk] : chunks) chunk->updateRender(pixelSize);
 }
 
 void ChunkManager::updateColliders() {
-	for (auto& vec : chunks)
-		for (Chunk& chunk : vec) chunk.updateColliders();
+	for (auto& [pos, chunk] : chunks) chunk->updateColliders();
 }
 
 void ChunkManager::updateActiveChunks(const Vec2& pos, const int range) {
 	const auto [midX, midY] = posToChunk(posToTerrainCoord(pos));
 	activeChunks.clear();
+	if (streaming) {
+		unloadDistantChunks(midX, midY);
+		// Also the ring just outside the active chunks, so it is ready ahead of time
+		loadChunksInRange(midX, midY, range + 1);
+	}
 
-	std::size_t startX = std::max(static_cast<std::size_t>(0), midX - range);
-	std::size_t endX = std::min(getChunksX() - 1, midX + range);
-	std::size_t startY = std::max(static_cast<std::size_t>(0), midY - range + 1);
-	std::size_t endY = std::min(getChunksY() - 1, midY + range - 1);
+	const std::size_t startX = midX >= range ? midX - range : 0;
+	const std::size_t endX = std::min(getChunksX() - 1, midX + range);
+	const std::size_t startY = midY + 1 >= range ? midY - range + 1 : 0;
+	const std::size_t endY = std::min(getChunksY() - 1, midY + range - 1);
 
 	auto setChunkAsEdge = [this](Chunk& chunk) {
 		chunk.state = Chunk::EDGE;
@@ -61,29 +121,74 @@ void ChunkManager::updateActiveChunks(const Vec2& pos, const int range) {
 
 	// Set top chunks to EDGE
 	if (midY >= range)
-		for (std::size_t x = startX; x <= endX; x++) setChunkAsEdge(chunks[midY - range][x]);
+		for (std::size_t x = startX; x <= endX; x++) setChunkAsEdge(loadChunk(x, midY - range));
 	// Set bottom chunks to EDGE
 	if (midY + range < getChunksY())
-		for (std::size_t x = startX; x <= endX; x++) setChunkAsEdge(chunks[midY + range][x]);
+		for (std::size_t x = startX; x <= endX; x++) setChunkAsEdge(loadChunk(x, midY + range));
 	// Set leftmost chunks to EDGE
 	if (midX >= range)
-		for (std::size_t y = startY; y <= endY; y++) setChunkAsEdge(chunks[y][midX - range]);
+		for (std::size_t y = startY; y <= endY; y++) setChunkAsEdge(loadChunk(midX - range, y));
 	// Set rightmost chunks to EDGE
 	if (midX + range < getChunksX())
-		for (std::size_t y = startY; y <= endY; y++) setChunkAsEdge(chunks[y][midX + range]);
+		for (std::size_t y = startY; y <= endY; y++) setChunkAsEdge(loadChunk(midX + range, y));
 
 	// Get the rest of the chunks that are not on the edge
 	auto normalChunks = getChunksInRange(midX, midY, range - 1);
 	for (Chunk& chunk : normalChunks) chunk.state = Chunk::NORMAL;
-	chunks[midY][midX].state = Chunk::CENTER;
+	loadChunk(midX, midY).state = Chunk::CENTER;
 
 	activeChunks.insert(activeChunks.end(), normalChunks.begin(), normalChunks.end());
+
+	updateResidency(midX, midY, range);
+}
+
+void ChunkManager::updateResidency(const std::size_t midX, const std::size_t midY,
+                                   const int range) {
+	for (Chunk& chunk : activeChunks) chunk.makeResident();
+
+	// The loaded ring around the active chunks covers what their distance fields read
+	std::map<std::pair<std::size_t, std::size_t>, DistanceField> fields;
+	std::vector<DistanceField*> newFields;
+	for (const Chunk& chunk : activeChunks) {
+		// Origins are whole cells, so the division is exact
+		const std::pair<std::size_t, std::size_t> pos = posToChunk(
+		    std::make_pair(std::lround(chunk.getOriginX() / pixelSize) + originCellX,
+		                   std::lround(chunk.getOriginY() / pixelSize) + originCellY));
+		const auto it = distanceFields.find(pos);
+		if (it != distanceFields.end()) {
+			fields.emplace(pos, std::move(it->second));
+			continue;
+		}
+
+		const std::ptrdiff_t x = pos.first * chunkSize;
+		const std::ptrdiff_t y = pos.second * chunkSize;
+		const auto [added, inserted] =
+		    fields.emplace(pos, DistanceField{x - 1, y - 1, chunkSize + 2, chunkSize + 2});
+		newFields.push_back(&added->second);
+	}
+	distanceFields = std::move(fields);
+	if (!newFields.empty()) flowFieldOutdated = true;
+	const DistanceField::CellReader reader = [this](CellGrid& window, std::ptrdiff_t x,
+	                                                std::ptrdiff_t y) { readCells(window, x, y); };
+	scene.getGame().getThreadPool().parallelFor(
+	    newFields.size(), [&](const std::size_t i) { newFields[i]->update(reader); });
+
+	for (auto& [pos, chunk] : chunks) {
+		const std::size_t distX = std::max(pos.first, midX) - std::min(pos.first, midX);
+		const std::size_t distY = std::max(pos.second, midY) - std::min(pos.second, midY);
+		const std::size_t dist = std::max(distX, distY);
+		if (dist == range + 1)
+			chunk->prefetch();
+		else if (dist > range + 1)
+			chunk->makeCompact();
+	}
 }
 
 void ChunkManager::render(SDL_Renderer* renderer, const Camera& cam) const {
 	SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
 
-	for (const Chunk& chunk : activeChunks) chunk.render(renderer, cam);
+	const Vec2& viewSize = scene.getGame().getWinDimensions();
+	for (const Chunk& chunk : activeChunks) chunk.render(renderer, cam, viewSize);
 }
 
 void ChunkManager::changeTerrain(const Vec2& position, const unsigned char value) {
@@ -99,55 +204,292 @@ void ChunkManager::changeTerrain(const std::pair<std::size_t, std::size_t>& posi
 void ChunkManager::changeTerrain(const std::size_t x, const std::size_t y,
                                  const unsigned char value) {
 	if (x >= terrainXSize || y >= terrainYSize) return;
-	pendingTerrainChanges.emplace(x, y, value);
+	pendingTerrainSpans.push_back(TerrainSpan{y, x, x + 1, value});
 }
 
 void ChunkManager::changeTerrainInRange(const Vec2& center, int range, const unsigned char value) {
-	++range;  // Increment range to make calculations work correctly
+	const auto [cX, cY] = posToTerrainCoord(center);
+	TerrainShapes::circle(cX, cY, range, value, terrainXSize, terrainYSize, pendingTerrainSpans);
+}
+
+void ChunkManager::changeTerrainRect(const Vec2& corner1, const Vec2& corner2,
+                                     const unsigned char value) {
+	const auto [x1, y1] = posToTerrainCoord(corner1);
+	const auto [x2, y2] = posToTerrainCoord(corner2);
+	TerrainShapes::rectangle(x1, y1, x2, y2, value, terrainXSize, terrainYSize,
+	                         pendingTerrainSpans);
+}
+
+void ChunkManager::changeTerrainCapsule(const Vec2& start, const Vec2& end, const int range,
+                                        const unsigned char value) {
+	const auto [x1, y1] = posToTerrainCoord(start);
+	const auto [x2, y2] = posToTerrainCoord(end);
+	TerrainShapes::capsule(x1, y1, x2, y2, range, value, terrainXSize, terrainYSize,
+	                       pendingTerrainSpans);
+}
+
+void ChunkManager::executeTerrainChanges() {
+	// Split at the chunk borders, so every span is inside one chunk
+	std::vector<TerrainSpan> pieces;
+	pieces.reserve(pendingTerrainSpans.size());
+	for (const TerrainSpan& span : pendingTerrainSpans) {
+		for (std::size_t x = span.x1; x < span.x2;) {
+			const std::size_t end = std::min(span.x2, (x / chunkSize + 1) * chunkSize);
+			pieces.push_back(TerrainSpan{span.y, x, end, span.value});
+			x = end;
+		}
+	}
+	pendingTerrainSpans.clear();
+
+	// Bounding box of the chunks that are changed, one bucket for every chunk in it
+	std::size_t minX = chunksX, minY = chunksY, maxX = 0, maxY = 0;
+	for (const TerrainSpan& span : pieces) {
+		const auto [x, y] = posToChunk(std::make_pair(span.x1, span.y));
+		minX = std::min(minX, x);
+		minY = std::min(minY, y);
+		maxX = std::max(maxX, x);
+		maxY = std::max(maxY, y);
+	}
+	const std::size_t boxX = maxX - minX + 1;
+	auto bucketOf = [this, minX, minY, boxX](const TerrainSpan& span) {
+		return (span.y / chunkSize - minY) * boxX + span.x1 / chunkSize - minX;
+	};
 
-	// Find the height (sine) of every x position based on the range (radius)
-	std::vector<int> maxY(range);
-	for (int x = 0; x < range; ++x) {
-		maxY[x] = std::round(std::sin(std::acos((float)x / range)) * range);
+	// Counting sort, so every chunk's spans end up contiguous and in the order they were made
+	std::vector<std::size_t> bucketStart(boxX * (maxY - minY + 1) + 1);
+	for (const TerrainSpan& span : pieces) bucketStart[bucketOf(span) + 1]++;
+	for (std::size_t i = 1; i < bucketStart.size(); i++) bucketStart[i] += bucketStart[i - 1];
+
+	std::vector<TerrainSpan> sorted(pieces.size());
+	std::vector<std::size_t> bucketEnd(bucketStart.begin(), bucketStart.end() - 1);
+	// Changed cells of every bucket, in world cells, for updating the distance fields
+	struct Box {
+		std::size_t x1 = std::numeric_limits<std::size_t>::max(), y1 = x1, x2 = 0, y2 = 0;
+	};
+	std::vector<Box> changedBoxes(bucketEnd.size());
+	for (const TerrainSpan& span : pieces) {
+		const std::size_t bucket = bucketOf(span);
+		const std::size_t chunkX = span.x1 / chunkSize * chunkSize;
+		sorted[bucketEnd[bucket]++] =
+		    TerrainSpan{span.y % chunkSize, span.x1 - chunkX, span.x2 - chunkX, span.value};
+
+		Box& box = changedBoxes[bucket];
+		box.x1 = std::min(box.x1, span.x1);
+		box.y1 = std::min(box.y1, span.y);
+		box.x2 = std::max(box.x2, span.x2 - 1);
+		box.y2 = std::max(box.y2, span.y);
 	}
 
-	const auto [cX, cY] = posToTerrainCoord(center);
-	std::map<std::pair<std::size_t, std::size_t>, std::vector<std::pair<std::size_t, std::size_t>>>
-	    chunkMap;
-	// Loop through and deactivate pixels
-	for (int x = -range + 1; x < range; ++x) {
-		if (cX + x < 0 || cX + x >= terrainXSize) continue;
-		for (int y = -maxY[std::abs(x)] + 1; y < maxY[std::abs(x)]; ++y) {
-			if (cY + y < 0 || cY + y >= terrainYSize) continue;
-			changeTerrain(cX + x, cY + y, value);
+	// Loading chunks changes the chunk map, so that is done here before going parallel
+	std::vector<std::pair<Chunk*, std::span<const TerrainSpan>>> work;
+	for (std::size_t bucket = 0; bucket + 1 < bucketStart.size(); bucket++) {
+		const std::size_t count = bucketEnd[bucket] - bucketStart[bucket];
+		if (count == 0) continue;
+
+		const std::pair<std::size_t, std::size_t> chunkPos{minX + bucket % boxX,
+		                                                   minY + bucket / boxX};
+		const std::span<const TerrainSpan> spans{sorted.data() + bucketStart[bucket], count};
+		work.emplace_back(&loadChunk(chunkPos.first, chunkPos.second), spans);
+		editedChunks.insert(chunkPos);
+	}
+
+	ThreadPool& pool = scene.getGame().getThreadPool();
+	pool.parallelFor(work.size(), [&work](const std::size_t i) {
+		// Overlapping edits in a chunk only write every cell once
+		const std::vector<TerrainSpan> spans = TerrainShapes::coalesce(work[i].second);
+		work[i].first->changeTerrainSpans(spans);
+	});
+
+	flowFieldOutdated = true;
+	regionsOutdated = true;
+	// Every field reaching within maxDistance of a change is updated around it
+	std::vector<DistanceField*> fields;
+	for (auto& [pos, field] : distanceFields) fields.push_back(&field);
+	const DistanceField::CellReader reader = [this](CellGrid& window, std::ptrdiff_t x,
+	                                                std::ptrdiff_t y) { readCells(window, x, y); };
+	pool.parallelFor(fields.size(), [&](const std::size_t i) {
+		constexpr std::ptrdiff_t reach = DistanceField::maxDistance;
+		for (const Box& box : changedBoxes) {
+			if (box.x1 > box.x2) continue;  // No changes in this bucket
+			fields[i]->update(reader, static_cast<std::ptrdiff_t>(box.x1) - reach,
+			                  static_cast<std::ptrdiff_t>(box.y1) - reach,
+			                  static_cast<std::ptrdiff_t>(box.x2) + reach,
+			                  static_cast<std::ptrdiff_t>(box.y2) + reach);
 		}
+	});
+}
+
+void ChunkManager::updateRegions() {
+	regionsOutdated = false;
+	regionOffsets.clear();
+	std::uint32_t count = 0;
+	for (const auto& [pos, chunk] : chunks) {
+		regionOffsets.emplace(pos, count);
+		count += chunk->getRegions().getLabelCount();
+	}
+
+	UnionFind sets{count};
+	// Cells on both sides of the right and bottom border of every chunk
+	for (const auto& [pos, chunk] : chunks) {
+		const RegionLabels& regions = chunk->getRegions();
+		const std::uint32_t offset = regionOffsets.at(pos);
+		auto joinBorder = [&](const std::pair<std::size_t, std::size_t> otherPos,
+		                      const bool right) {
+			const auto other = chunks.find(otherPos);
+			if (other == chunks.end()) return;
+			const RegionLabels& otherRegions = other->second->getRegions();
+			const std::uint32_t otherOffset = regionOffsets.at(otherPos);
+			for (std::size_t i = 0; i < chunkSize; i++) {
+				const std::uint32_t region = right ? regions.getRegion(chunkSize - 1, i)
+				                                   : regions.getRegion(i, chunkSize - 1);
+				const std::uint32_t otherRegion =
+				    right ? otherRegions.getRegion(0, i) : otherRegions.getRegion(i, 0);
+				if (region != RegionLabels::noRegion && otherRegion != RegionLabels::noRegion)
+					sets.unite(offset + region, otherOffset + otherRegion);
+			}
+		};
+		joinBorder(std::make_pair(pos.first + 1, pos.second), true);
+		joinBorder(std::make_pair(pos.first, pos.second + 1), false);
 	}
+
+	regionRoots.resize(count);
+	for (std::uint32_t i = 0; i < count; i++) regionRoots[i] = sets.find(i);
 }
 
-void ChunkManager::executeTerrainChanges() {
-	std::map<std::pair<std::size_t, std::size_t>, std::vector<TerrainChange>> chunkMap;
+std::optional<std::uint32_t> ChunkManager::getRegion(const Vec2& pos) const {
+	// The offsets do not match the chunks until the next update
+	if (regionsOutdated) return std::nullopt;
+	const auto [x, y] = posToTerrainCoord(pos);
+	const std::pair<std::size_t, std::size_t> chunkPos = posToChunk(std::make_pair(x, y));
+	const auto chunk = chunks.find(chunkPos);
+	const auto offset = regionOffsets.find(chunkPos);
+	if (chunk == chunks.end() || offset == regionOffsets.end()) return std::nullopt;
+
+	const std::uint32_t region =
+	    chunk->second->getRegions().getRegion(x % chunkSize, y % chunkSize);
+	if (region == RegionLabels::noRegion) return std::nullopt;
+	return regionRoots[offset->second + region];
+}
+
+bool ChunkManager::isConnected(const Vec2& a, const Vec2& b) const {
+	const std::optional<std::uint32_t> region = getRegion(a);
+	return region && region == getRegion(b);
+}
+
+bool ChunkManager::isConnectedToPlayer(const Vec2& pos) const {
+	return playerRegion && playerRegion == getRegion(pos);
+}
 
-	while (!pendingTerrainChanges.empty()) {
-		TerrainChange change = std::move(pendingTerrainChanges.front());
-		pendingTerrainChanges.pop();
-		auto chunkPos = posToChunk(std::make_pair(change.x, change.y));
-		auto localX = change.x % chunkSize;
-		auto localY = change.y % chunkSize;
-		chunkMap[chunkPos].emplace_back(localX, localY, change.value);
+void ChunkManager::updateFlowField(const Vec2& playerPos) {
+	if (pendingFlowField.valid() || distanceFields.empty()) return;
+	const auto [targetX, targetY] = posToTerrainCoord(playerPos);
+	if (!flowFieldOutdated && !flowField.isEmpty() && flowField.getTargetX() == targetX &&
+	    flowField.getTargetY() == targetY)
+		return;
+	flowFieldOutdated = false;
+
+	// Area of the active chunks, which all have distance fields
+	const std::size_t x1 = distanceFields.begin()->first.first;
+	const std::size_t y1 = distanceFields.begin()->first.second;
+	const std::size_t x2 = distanceFields.rbegin()->first.first;
+	const std::size_t y2 = distanceFields.rbegin()->first.second;
+	const std::size_t originX = x1 * chunkSize, originY = y1 * chunkSize;
+	CellGrid cells{(x2 - x1 + 1) * chunkSize, (y2 - y1 + 1) * chunkSize};
+	readCells(cells, originX, originY);
+	std::vector<float> wallDistance(cells.cells.size());
+	for (const auto& [pos, field] : distanceFields) {
+		const std::size_t startX = pos.first * chunkSize, startY = pos.second * chunkSize;
+		for (std::size_t y = startY; y < startY + chunkSize; y++) {
+			float* row = wallDistance.data() + (y - originY) * cells.xSize - originX;
+			for (std::size_t x = startX; x < startX + chunkSize; x++)
+				row[x] = field.getDistance(x, y);
+		}
 	}
 
-	for (auto& [chunk, changes] : chunkMap) {
-		auto [x, y] = chunk;
-		chunks[y][x].changeTerrainMultiple(changes);
+	pendingFlowField = scene.getGame().getThreadPool().submit(
+	    [cells = std::move(cells), wallDistance = std::move(wallDistance), originX, originY,
+	     targetX, targetY] {
+		    return FlowField{cells, wallDistance, originX, originY, targetX, targetY};
+	    });
+}
+
+std::optional<Vec2> ChunkManager::getFlowDirection(const Vec2& pos) const {
+	const auto [x, y] = posToTerrainCoord(pos);
+	return flowField.getDirection(x, y);
+}
+
+void ChunkManager::readCells(CellGrid& window, const std::ptrdiff_t x,
+                             const std::ptrdiff_t y) const {
+	// Clipped to the world, the rest stays empty
+	const std::ptrdiff_t x1 = std::max<std::ptrdiff_t>(x, 0);
+	const std::ptrdiff_t y1 = std::max<std::ptrdiff_t>(y, 0);
+	const std::ptrdiff_t x2 = std::min<std::ptrdiff_t>(x + window.xSize, terrainXSize);
+	const std::ptrdiff_t y2 = std::min<std::ptrdiff_t>(y + window.ySize, terrainYSize);
+	if (x1 >= x2 || y1 >= y2) return;
+
+	const std::ptrdiff_t size = chunkSize;
+	for (std::ptrdiff_t chunkY = y1 / size; chunkY * size < y2; chunkY++) {
+		for (std::ptrdiff_t chunkX = x1 / size; chunkX * size < x2; chunkX++) {
+			const Chunk* chunk = getChunk(chunkX, chunkY);
+			if (!chunk) continue;
+
+			// Part of the window inside this chunk
+			const std::ptrdiff_t startX = std::max(x1, chunkX * size);
+			const std::ptrdiff_t endX = std::min(x2, (chunkX + 1) * size);
+			const std::ptrdiff_t startY = std::max(y1, chunkY * size);
+			const std::ptrdiff_t endY = std::min(y2, (chunkY + 1) * size);
+			const Terrain& terrain = chunk->getTerrain();
+			for (std::ptrdiff_t cellY = startY; cellY < endY; cellY++) {
+				const auto row = terrain.map[cellY - chunkY * size].begin() - chunkX * size;
+				std::copy(row + startX, row + endX, window.row(cellY - y) + (startX - x));
+			}
+		}
 	}
 }
 
+std::optional<ChunkManager::WallDistance> ChunkManager::getWallDistance(const Vec2& pos) const {
+	const auto [x, y] = posToTerrainCoord(pos);
+	const auto it = distanceFields.find(posToChunk(std::make_pair(x, y)));
+	if (it == distanceFields.end()) return std::nullopt;
+
+	// Position inside the cell, pos is relative to the origin so this is precise
+	const Vec2 offset{pos.x / pixelSize - std::floor(pos.x / pixelSize),
+	                  pos.y / pixelSize - std::floor(pos.y / pixelSize)};
+	if (!it->second.contains(x, y, offset)) return std::nullopt;
+	const DistanceField::Sample sample = it->second.sample(x, y, offset);
+	return WallDistance{sample.distance * pixelSize, sample.direction};
+}
+
 std::pair<std::size_t, std::size_t> ChunkManager::posToTerrainCoord(const Vec2& position) const {
-	const std::size_t x = position.x / pixelSize;
-	const std::size_t y = position.y / pixelSize;
+	// Negative cells wrap around to indices outside the terrain
+	const std::size_t x = static_cast<std::ptrdiff_t>(std::floor(position.x / pixelSize)) +
+	                      originCellX;
+	const std::size_t y = static_cast<std::ptrdiff_t>(std::floor(position.y / pixelSize)) +
+	                      originCellY;
 	return std::make_pair(x, y);
 }
 
+Vec2 ChunkManager::recenterOrigin(const Vec2& pos) {
+	const float chunkPixels = chunkSize * pixelSize;
+	const float limit = recenterChunks * chunkPixels;
+	if (std::abs(pos.x) <= limit && std::abs(pos.y) <= limit) return Vec2{};
+
+	// To the chunk pos is in, so chunk origins stay on whole cells
+	const std::ptrdiff_t stepX = std::floor(pos.x / chunkPixels);
+	const std::ptrdiff_t stepY = std::floor(pos.y / chunkPixels);
+	originCellX += stepX * static_cast<std::ptrdiff_t>(chunkSize);
+	originCellY += stepY * static_cast<std::ptrdiff_t>(chunkSize);
+	const Vec2 offset{-stepX * chunkPixels, -stepY * chunkPixels};
+	for (auto& [chunkPos, chunk] : chunks) chunk->shiftOrigin(offset);
+	return offset;
+}
+
+Vec2 ChunkManager::getChunkOrigin(const std::size_t x, const std::size_t y) const {
+	const std::ptrdiff_t cellX = static_cast<std::ptrdiff_t>(x * chunkSize) - originCellX;
+	const std::ptrdiff_t cellY = static_cast<std::ptrdiff_t>(y * chunkSize) - originCellY;
+	return Vec2{static_cast<float>(cellX * pixelSize), static_cast<float>(cellY * pixelSize)};
+}
+
 std::pair<std::size_t, std::size_t> ChunkManager::posToChunk(
     const std::pair<std::size_t, std::size_t>& pos) const {
 	assert(chunkSize != 0);
@@ -157,33 +499,146 @@ std::pair<std::size_t, std::size_t> ChunkManager::posToChunk(
 	return std::move(std::make_pair(x, y));
 }
 
-std::vector<std::vector<Chunk>> ChunkManager::splitToChunks(const Terrain& terrain,
-                                                            const std::size_t chunkSize) {
+void ChunkManager::splitToChunks(const Terrain& terrain) {
 	assert(terrain.getXSize() % chunkSize == 0 && terrain.getYSize() % chunkSize == 0 &&
 	       "chunkSize must divide terrain x- and y-size.");
+	const auto start = Timing::Clock::now();
+
+	std::vector<std::unique_ptr<Chunk>> built(chunksX * chunksY);
+	std::vector<LoadTimings> timings(built.size());
+	scene.getGame().getThreadPool().parallelFor(built.size(), [&](const std::size_t i) {
+		const std::size_t x = i % chunksX;
+		const std::size_t y = i / chunksX;
+
+		// Copy this chunk's part of the terrain map and initialize the chunk with it
+		const auto splitStart = Timing::Clock::now();
+		std::vector<std::vector<unsigned char>> chunkMap(chunkSize);
+		for (std::size_t localY = 0; localY < chunkSize; localY++) {
+			const auto& row = terrain.map[y * chunkSize + localY];
+			chunkMap[localY].assign(row.begin() + x * chunkSize, row.begin() + (x + 1) * chunkSize);
+		}
+		timings[i].split = Timing::secondsSince(splitStart);
 
-	const std::size_t chunksX = terrain.getXSize() / chunkSize;
-	const std::size_t chunksY = terrain.getYSize() / chunkSize;
-	std::vector<std::vector<Chunk>> result(chunksY);
-
-	for (std::size_t y = 0; y < chunksY; y++) {
-		result[y].reserve(chunksX);
-		for (std::size_t x = 0; x < chunksX; x++) {
-			// Copy this chunk's part of the terrain map and initialize the chunk with it
-			std::vector<std::vector<unsigned char>> chunkMap(chunkSize,
-			                                                 std::vector<unsigned char>(chunkSize));
-			for (int chunkY = y * chunkSize, localY = 0; chunkY < (y + 1) * chunkSize;
-			     chunkY++, localY++) {
-				std::copy(terrain.map[chunkY].begin() + x * chunkSize,
-				          terrain.map[chunkY].begin() + (x + 1) * chunkSize,
-				          chunkMap[localY].begin());
-			}
+		const Vec2 origin = getChunkOrigin(x, y);
+		built[i] = std::make_unique<Chunk>(std::move(chunkMap), origin.x, origin.y, *this,
+		                                   enemyManager, &timings[i].build);
+	});
+
+	for (std::size_t i = 0; i < built.size(); i++) {
+		chunks.emplace(std::make_pair(i % chunksX, i / chunksX), std::move(built[i]));
+		loadTimings += timings[i];
+	}
+	loadTimings.chunks += built.size();
+	loadTimings.wall += Timing::secondsSince(start);
+}
+
+const Chunk* ChunkManager::getChunk(const std::size_t x, const std::size_t y) const {
+	const auto it = chunks.find(std::make_pair(x, y));
+	return it != chunks.end() ? it->second.get() : nullptr;
+}
+
+Chunk& ChunkManager::loadChunk(const std::size_t x, const std::size_t y) {
+	assert(x < chunksX && y < chunksY && "Chunk position must be inside the world.");
+
+	const std::pair<std::size_t, std::size_t> pos{x, y};
+	auto it = chunks.find(pos);
+	if (it != chunks.end()) return *it->second;
+
+	assert(streaming && "All chunks are loaded when not streaming.");
+	const auto start = Timing::Clock::now();
+	regionsOutdated = true;
+	Chunk& chunk = *chunks.emplace(pos, createChunk(x, y, takeStored(x, y), loadTimings))
+	                     .first->second;
+	loadTimings.chunks++;
+	loadTimings.wall += Timing::secondsSince(start);
+	return chunk;
+}
+
+void ChunkManager::loadChunksInRange(const std::size_t midX, const std::size_t midY,
+                                     const int range, LoadingProgress* progress) {
+	const auto start = Timing::Clock::now();
+	const std::size_t minX = (midX > range) ? midX - range : 0;
+	const std::size_t maxX = std::min(midX + range, getChunksX() - 1);
+	const std::size_t minY = (midY > range) ? midY - range : 0;
+	const std::size_t maxY = std::min(midY + range, getChunksY() - 1);
+
+	std::vector<std::pair<std::size_t, std::size_t>> missing;
+	for (std::size_t y = minY; y <= maxY; y++)
+		for (std::size_t x = minX; x <= maxX; x++)
+			if (!chunks.contains(std::make_pair(x, y))) missing.emplace_back(x, y);
+	if (progress) progress->start(missing.size());
+	if (missing.empty()) return;
+
+	std::vector<std::optional<Terrain>> stored;
+	stored.reserve(missing.size());
+	for (const auto [x, y] : missing) stored.push_back(takeStored(x, y));
+
+	std::vector<std::unique_ptr<Chunk>> built(missing.size());
+	std::vector<LoadTimings> timings(missing.size());
+	scene.getGame().getThreadPool().parallelFor(missing.size(), [&](const std::size_t i) {
+		built[i] = createChunk(missing[i].first, missing[i].second, std::move(stored[i]),
+		                       timings[i]);
+		if (progress) progress->advance();
+	});
+
+	for (std::size_t i = 0; i < missing.size(); i++) {
+		chunks.emplace(missing[i], std::move(built[i]));
+		regionsOutdated = true;
+		loadTimings += timings[i];
+	}
+	loadTimings.chunks += missing.size();
+	loadTimings.wall += Timing::secondsSince(start);
+}
+
+std::optional<Terrain> ChunkManager::takeStored(const std::size_t x, const std::size_t y) {
+	if (!streaming->store.contains(x, y)) return std::nullopt;
+	return streaming->store.load(x, y);
+}
+
+std::unique_ptr<Chunk> ChunkManager::createChunk(const std::size_t x, const std::size_t y,
+                                                 std::optional<Terrain>&& stored,
+                                                 LoadTimings& timings) {
+	const auto start = Timing::Clock::now();
+	const Vec2 origin = getChunkOrigin(x, y);
+	const float originX = origin.x, originY = origin.y;
+
+	if (stored) {
+		timings.generate += Timing::secondsSince(start);
+		return std::make_unique<Chunk>(std::move(stored->map), originX, originY, *this,
+		                               enemyManager, &timings.build);
+	}
+	if (streaming->bake && streaming->bake->contains(x, y)) {
+		// Segments are used as they are, only the terrain is decoded
+		const WorldBake& bake = *streaming->bake;
+		Terrain terrain = bake.getTerrain(x, y);
+		timings.generate += Timing::secondsSince(start);
+		return std::make_unique<Chunk>(std::move(terrain.map), originX, originY, *this,
+		                               enemyManager, bake.getSegments(x, y), &timings.build);
+	}
 
-			result[y].emplace_back(std::move(chunkMap), x * chunkSize * pixelSize,
-			                       y * chunkSize * pixelSize, *this, enemyManager);
+	Terrain terrain = streaming->generator.generateChunk(
+	    x, y, chunkSize, terrainXSize, terrainYSize, streaming->shapeSize, streaming->seed,
+	    scene.getGame().getThreadPool());
+	timings.generate += Timing::secondsSince(start);
+	return std::make_unique<Chunk>(std::move(terrain.map), originX, originY, *this, enemyManager,
+	                               &timings.build);
+}
+
+void ChunkManager::unloadDistantChunks(const std::size_t midX, const std::size_t midY) {
+	for (auto it = chunks.begin(); it != chunks.end();) {
+		const auto [x, y] = it->first;
+		const std::size_t distX = std::max(x, midX) - std::min(x, midX);
+		const std::size_t distY = std::max(y, midY) - std::min(y, midY);
+		if (distX <= unloadRange && distY <= unloadRange) {
+			++it;
+			continue;
 		}
+
+		if (editedChunks.erase(it->first))
+			streaming->store.store(x, y, Terrain{it->second->getTerrain()});
+		it = chunks.erase(it);
+		regionsOutdated = true;
 	}
-	return result;
 }
 
 std::vector<std::reference_wrapper<Chunk>> ChunkManager::getChunksInRange(const std::size_t midX,
@@ -196,7 +651,7 @@ std::vector<std::reference_wrapper<Chunk>> ChunkManager::getChunksInRange(const
 	const std::size_t maxY = std::min(midY + range, getChunksY() - 1);
 
 	for (std::size_t x = minX; x <= maxX; x++)
-		for (std::size_t y = minY; y <= maxY; y++) result.push_back(chunks[y][x]);
+		for (std::size_t y = minY; y <= maxY; y++) result.push_back(loadChunk(x, y));
 
 	return result;
 }
@@ -204,24 +659,72 @@ std::vector<std::reference_wrapper<Chunk>> ChunkManager::getChunksInRange(const
 std::vector<std::reference_wrapper<const Chunk>> ChunkManager::getConstChunksInRange(
     const std::size_t midX, const std::size_t midY, const int range) const {
 	std::vector<std::reference_wrapper<const Chunk>> result;
-	const std::size_t minX = std::max(midX - range, static_cast<std::size_t>(0));
+	const std::size_t minX = (midX > range) ? midX - range : 0;
 	const std::size_t maxX = std::min(midX + range, getChunksX() - 1);
-	const std::size_t minY = std::max(midY - range, static_cast<std::size_t>(0));
+	const std::size_t minY = (midY > range) ? midY - range : 0;
 	const std::size_t maxY = std::min(midY + range, getChunksY() - 1);
 
-	for (std::size_t x = minX; x <= maxX; x++)
-		for (std::size_t y = minY; y <= maxY; y++) result.push_back(chunks[y][x]);
+	// Only chunks that are loaded
+	for (std::size_t x = minX; x <= maxX; x++) {
+		for (std::size_t y = minY; y <= maxY; y++) {
+			const Chunk* chunk = getChunk(x, y);
+			if (chunk) result.push_back(*chunk);
+		}
+	}
 
 	return result;
 }
 
 std::vector<Vec2> ChunkManager::getAllSpawns() const {
 	std::vector<Vec2> spawns;
-	for (const auto& chunkList : chunks) {
-		for (const Chunk& chunk : chunkList) {
-			const auto chunkSpawns = chunk.findSpawnPositions();
-			spawns.insert(spawns.end(), chunkSpawns.begin(), chunkSpawns.end());
-		}
+	for (const auto& [pos, chunk] : chunks) {
+		const auto chunkSpawns = chunk->findSpawnPositions();
+		spawns.insert(spawns.end(), chunkSpawns.begin(), chunkSpawns.end());
 	}
 	return spawns;
 }
+
+std::vector<Vec2> ChunkManager::getSpawnsAround(const Vec2& pos) {
+	const auto [midX, midY] = posToChunk(posToTerrainCoord(pos));
+	if (streaming) loadChunksInRange(midX, midY, chunkRange);
+
+	std::vector<Vec2> spawns;
+	for (const Chunk& chunk : getChunksInRange(midX, midY, chunkRange)) {
+		const auto chunkSpawns = chunk.findSpawnPositions();
+		spawns.insert(spawns.end(), chunkSpawns.begin(), chunkSpawns.end());
+	}
+	return spawns;
+}
+
+void ChunkManager::preloadAround(const Vec2& pos, LoadingProgress* progress) {
+	if (!streaming) {
+		if (progress) progress->start(0);
+		return;
+	}
+	const auto [midX, midY] = posToChunk(posToTerrainCoord(pos));
+	// Same as updateActiveChunks, the active chunks and the ring around them
+	loadChunksInRange(midX, midY, chunkRange + 1, progress);
+}
+
+Vec2 ChunkManager::getWorldCenter() const {
+	const std::ptrdiff_t x = terrainXSize * pixelSize / 2 - originCellX * pixelSize;
+	const std::ptrdiff_t y = terrainYSize * pixelSize / 2 - originCellY * pixelSize;
+	return Vec2{static_cast<float>(x), static_cast<float>(y)};
+}
+
+ChunkManager::LoadTimings& ChunkManager::LoadTimings::operator+=(const LoadTimings& other) {
+	generate += other.generate;
+	split += other.split;
+	build += other.build;
+	wall += other.wall;
+	chunks += other.chunks;
+	return *this;
+}
+
+std::ostream& operator<<(std::ostream& os, const ChunkManager::LoadTimings& timings) {
+	auto ms = [](const double seconds) { return static_cast<long>(seconds * 1000); };
+	return os << timings.chunks << " chunks in " << ms(timings.wall) << " ms (summed over threads: "
+	          << "generate " << ms(timings.generate) << " ms, split " << ms(timings.split)
+	          << " ms, colliders " << ms(timings.build.colliders) << " ms, spawns "
+	          << ms(timings.build.spawns) << " ms, render " << ms(timings.build.render) << " ms)";
+}
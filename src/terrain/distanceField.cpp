@@ -0,0 +1,130 @@
+#include "terrain/distanceField.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+namespace {
+/* Lower envelope of the parabolas (x - q)^2 + f[q] over one row, the second pass of the
+ * transform by Felzenszwalb and Huttenlocher.
+ *
+ * @param f Squared distances along the columns, every cell of the row.
+ * @param d Squared distances are written here.
+ * @param v, z Scratch space for n and n + 1 values.
+ */
+void transformRow(const int* f, int* d, const int n, int* v, float* z) {
+	int k = 0;
+	v[0] = 0;
+	z[0] = -INFINITY;
+	z[1] = INFINITY;
+	auto intersection = [f](const int q, const int p) {
+		return static_cast<float>(f[q] + q * q - f[p] - p * p) / (2 * (q - p));
+	};
+	for (int q = 1; q < n; q++) {
+		float s = intersection(q, v[k]);
+		// z[0] is -infinity, so this stops at the first parabola
+		while (s <= z[k]) s = intersection(q, v[--k]);
+		k++;
+		v[k] = q;
+		z[k] = s;
+		z[k + 1] = INFINITY;
+	}
+
+	k = 0;
+	for (int q = 0; q < n; q++) {
+		while (z[k + 1] < q) k++;
+		d[q] = (q - v[k]) * (q - v[k]) + f[v[k]];
+	}
+}
+}  // namespace
+
+DistanceField::DistanceField(const std::ptrdiff_t originX, const std::ptrdiff_t originY,
+                             const std::size_t xSize, const std::size_t ySize)
+    : originX{originX},
+      originY{originY},
+      xSize{xSize},
+      ySize{ySize},
+      distances(xSize * ySize, maxDistance) {}
+
+void DistanceField::update(const CellReader& readCells, std::ptrdiff_t x1, std::ptrdiff_t y1,
+                           std::ptrdiff_t x2, std::ptrdiff_t y2) {
+	x1 = std::max(x1, originX);
+	y1 = std::max(y1, originY);
+	x2 = std::min<std::ptrdiff_t>(x2, originX + xSize - 1);
+	y2 = std::min<std::ptrdiff_t>(y2, originY + ySize - 1);
+	if (x1 > x2 || y1 > y2) return;
+
+	// Every filled cell that is close enough to matter for the updated cells is in the window
+	const std::ptrdiff_t windowX = x1 - maxDistance;
+	const std::ptrdiff_t windowY = y1 - maxDistance;
+	const int width = x2 - x1 + 1 + 2 * maxDistance;
+	const int height = y2 - y1 + 1 + 2 * maxDistance;
+	CellGrid window{static_cast<std::size_t>(width), static_cast<std::size_t>(height)};
+	readCells(window, windowX, windowY);
+
+	/* Along the columns, squared distance to the closest filled cell above or below. Columns
+	 * without one stop at maxDistance + 1, which still ends up capped after the rows.
+	 */
+	std::vector<int> columns(window.cells.size());
+	for (int x = 0; x < width; x++) {
+		int last = maxDistance + 1;
+		for (int y = 0; y < height; y++) {
+			last = window.at(x, y) ? 0 : std::min(last + 1, maxDistance + 1);
+			columns[y * width + x] = last;
+		}
+		last = maxDistance + 1;
+		for (int y = height - 1; y >= 0; y--) {
+			last = window.at(x, y) ? 0 : std::min(last + 1, maxDistance + 1);
+			int& distance = columns[y * width + x];
+			distance = std::min(distance, last);
+			distance *= distance;
+		}
+	}
+
+	// Along the rows, only the ones being updated
+	std::vector<int> row(width);
+	std::vector<int> v(width);
+	std::vector<float> z(width + 1);
+	for (std::ptrdiff_t y = y1; y <= y2; y++) {
+		transformRow(columns.data() + (y - windowY) * width, row.data(), width, v.data(),
+		             z.data());
+		float* out = distances.data() + (y - originY) * xSize - originX;
+		for (std::ptrdiff_t x = x1; x <= x2; x++) {
+			out[x] = std::min(std::sqrt(static_cast<float>(row[x - windowX])),
+			                  static_cast<float>(maxDistance));
+		}
+	}
+}
+
+DistanceField::Sample DistanceField::sample(const std::ptrdiff_t x, const std::ptrdiff_t y,
+                                            const Vec2& offset) const {
+	assert(contains(x, y, offset) && "Position must be at least half a cell inside the field.");
+
+	// Relative to the center of the first cell
+	const float fieldX = (x - originX) + offset.x - 0.5f;
+	const float fieldY = (y - originY) + offset.y - 0.5f;
+	const std::size_t cellX = std::min<std::size_t>(fieldX, xSize - 2);
+	const std::size_t cellY = std::min<std::size_t>(fieldY, ySize - 2);
+	const float tx = fieldX - cellX;
+	const float ty = fieldY - cellY;
+
+	const float* top = distances.data() + cellY * xSize + cellX;
+	const float* bottom = top + xSize;
+	const float topLeft = top[0], topRight = top[1];
+	const float bottomLeft = bottom[0], bottomRight = bottom[1];
+
+	const float distance = (topLeft * (1 - tx) + topRight * tx) * (1 - ty) +
+	                       (bottomLeft * (1 - tx) + bottomRight * tx) * ty;
+	const Vec2 gradient{(topRight - topLeft) * (1 - ty) + (bottomRight - bottomLeft) * ty,
+	                    (bottomLeft - topLeft) * (1 - tx) + (bottomRight - topRight) * tx};
+	const bool flat = gradient.x == 0 && gradient.y == 0;
+	return Sample{distance, flat ? Vec2{} : gradient.normalized()};
+}
+
+bool DistanceField::contains(const std::ptrdiff_t x, const std::ptrdiff_t y,
+                             const Vec2& offset) const {
+	const float fieldX = (x - originX) + offset.x;
+	const float fieldY = (y - originY) + offset.y;
+	return xSize >= 2 && ySize >= 2 && fieldX >= 0.5f && fieldY >= 0.5f &&
+	       fieldX <= xSize - 0.5f && fieldY <= ySize - 0.5f;
+}
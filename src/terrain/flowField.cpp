@@ -0,0 +1,112 @@
+#include "terrain/flowField.h"
+
+#include <array>
+#include <cassert>
+#include <cmath>
+
+namespace {
+// Steps to the 8 neighbours, the straight ones first
+constexpr std::array<int, 8> stepX{1, -1, 0, 0, 1, -1, 1, -1};
+constexpr std::array<int, 8> stepY{0, 0, 1, -1, 1, 1, -1, -1};
+constexpr int straightSteps = 4;
+
+// Larger than the most expensive step, so the costs in the queue never wrap onto each other
+constexpr std::size_t bucketCount = 64;
+static_assert(FlowField::diagonalCost + FlowField::avoidDistance * FlowField::nearWallCost <
+              bucketCount);
+}  // namespace
+
+FlowField::FlowField() : originX{0}, originY{0}, xSize{0}, ySize{0}, targetX{0}, targetY{0} {}
+
+FlowField::FlowField(const CellGrid& cells, const std::span<const float> wallDistance,
+                     const std::size_t originX, const std::size_t originY,
+                     const std::size_t targetX, const std::size_t targetY)
+    : originX{originX},
+      originY{originY},
+      xSize{cells.xSize},
+      ySize{cells.ySize},
+      targetX{targetX},
+      targetY{targetY},
+      costs(cells.cells.size(), unreached),
+      directions(cells.cells.size(), noDirection) {
+	assert(wallDistance.size() == cells.cells.size() && "Every cell needs a wall distance.");
+	const std::size_t localX = targetX - originX, localY = targetY - originY;
+	if (!inside(localX, localY) || cells.at(localX, localY)) return;
+
+	// Cost of stepping into every cell, apart from the length of the step
+	std::vector<std::uint32_t> cellCost(cells.cells.size());
+	for (std::size_t i = 0; i < cellCost.size(); i++) {
+		const float missing = avoidDistance - std::min<float>(wallDistance[i], avoidDistance);
+		cellCost[i] = static_cast<std::uint32_t>(std::ceil(missing)) * nearWallCost;
+	}
+
+	// Every bucket holds the cells with the same cost, modulo bucketCount
+	std::array<std::vector<std::uint32_t>, bucketCount> buckets;
+	std::size_t queued = 1;
+	costs[localY * xSize + localX] = 0;
+	buckets[0].push_back(localY * xSize + localX);
+	for (std::uint32_t current = 0; queued > 0; current++) {
+		std::vector<std::uint32_t>& bucket = buckets[current % bucketCount];
+		queued -= bucket.size();
+		for (const std::uint32_t index : bucket) {
+			if (costs[index] != current) continue;  // Was reached cheaper after being queued
+			const std::size_t x = index % xSize, y = index / xSize;
+
+			for (int step = 0; step < 8; step++) {
+				if (!canStep(cells, x, y, step)) continue;
+				// Paths are searched from the target, so this is the cost of stepping to index
+				const std::uint32_t next = (y + stepY[step]) * xSize + x + stepX[step];
+				const std::uint32_t cost = current + cellCost[index] +
+				                           (step < straightSteps ? straightCost : diagonalCost);
+				if (cost >= costs[next]) continue;
+
+				costs[next] = cost;
+				buckets[cost % bucketCount].push_back(next);
+				queued++;
+			}
+		}
+		bucket.clear();
+	}
+
+	// Every cell steps to the cheapest neighbour
+	for (std::size_t y = 0; y < ySize; y++) {
+		for (std::size_t x = 0; x < xSize; x++) {
+			const std::uint32_t cost = costs[y * xSize + x];
+			if (cost == unreached || cost == 0) continue;
+
+			std::uint32_t best = cost;
+			for (int step = 0; step < 8; step++) {
+				if (!canStep(cells, x, y, step)) continue;
+				const std::uint32_t next = costs[(y + stepY[step]) * xSize + x + stepX[step]];
+				if (next >= best) continue;
+				best = next;
+				directions[y * xSize + x] = step;
+			}
+		}
+	}
+}
+
+bool FlowField::canStep(const CellGrid& cells, const std::size_t x, const std::size_t y,
+                        const int step) const {
+	const std::ptrdiff_t nextX = x + stepX[step], nextY = y + stepY[step];
+	if (!inside(nextX, nextY) || cells.at(nextX, nextY)) return false;
+	if (step < straightSteps) return true;
+	return !cells.at(nextX, y) && !cells.at(x, nextY);
+}
+
+std::optional<Vec2> FlowField::getDirection(const std::size_t x, const std::size_t y) const {
+	if (x < originX || y < originY || !inside(x - originX, y - originY)) return std::nullopt;
+
+	const std::uint8_t step = directions[(y - originY) * xSize + x - originX];
+	if (step == noDirection) return std::nullopt;
+	constexpr float diagonal = 0.70710678f;
+	const float length = step < straightSteps ? 1 : diagonal;
+	return Vec2{stepX[step] * length, stepY[step] * length};
+}
+
+std::optional<std::uint32_t> FlowField::getCost(const std::size_t x, const std::size_t y) const {
+	if (x < originX || y < originY || !inside(x - originX, y - originY)) return std::nullopt;
+	const std::uint32_t cost = costs[(y - originY) * xSize + x - originX];
+	if (cost == unreached) return std::nullopt;
+	return cost;
+}
@@ -0,0 +1,51 @@
+#include "terrain/regionLabels.h"
+
+RegionLabels::RegionLabels() : xSize{0}, ySize{0}, sets{1}, roots{noRegion} {}
+
+RegionLabels::RegionLabels(const Terrain& terrain)
+    : xSize{terrain.getXSize()},
+      ySize{terrain.getYSize()},
+      labels(terrain.getXSize() * terrain.getYSize(), noRegion),
+      sets{1} {
+	// Only the neighbours above and to the left have labels yet, which is all that is needed
+	for (std::size_t y = 0; y < ySize; y++)
+		for (std::size_t x = 0; x < xSize; x++)
+			if (!terrain.map[y][x]) joinNeighbours(terrain, x, y);
+	updateRoots();
+}
+
+void RegionLabels::open(const Terrain& terrain,
+                        const std::span<const std::pair<std::size_t, std::size_t>> cells) {
+	// Every opened cell can add a label, so start over before the labels get out of hand
+	if (sets.size() + cells.size() > labels.size() + 1) {
+		*this = RegionLabels{terrain};
+		return;
+	}
+
+	for (const auto& [x, y] : cells) joinNeighbours(terrain, x, y);
+	updateRoots();
+}
+
+void RegionLabels::joinNeighbours(const Terrain& terrain, const std::size_t x,
+                                  const std::size_t y) {
+	std::uint32_t& label = labels[y * xSize + x];
+	if (label == noRegion) {
+		label = sets.size();
+		sets.add(1);
+	}
+
+	auto join = [&](const std::size_t otherX, const std::size_t otherY) {
+		const std::uint32_t other = labels[otherY * xSize + otherX];
+		if (other != noRegion && !terrain.map[otherY][otherX]) sets.unite(label, other);
+	};
+	if (x > 0) join(x - 1, y);
+	if (y > 0) join(x, y - 1);
+	if (x + 1 < xSize) join(x + 1, y);
+	if (y + 1 < ySize) join(x, y + 1);
+}
+
+void RegionLabels::updateRoots() {
+	roots.resize(sets.size());
+	roots[noRegion] = noRegion;
+	for (std::uint32_t label = 1; label < sets.size(); label++) roots[label] = sets.find(label);
+}
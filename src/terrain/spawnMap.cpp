@@ -0,0 +1,116 @@
+#include "terrain/spawnMap.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+const std::array<int, SpawnMap::minSpace> SpawnMap::circleY = [] {
+	std::array<int, minSpace> result;
+	for (int x = 0; x < minSpace; x++) {
+		result[x] = std::round(std::sin(std::acos(static_cast<double>(x) / minSpace)) * minSpace);
+	}
+	return result;
+}();
+
+SpawnMap::SpawnMap() : xSize{0}, ySize{0}, wordsPerRow{0}, count{0} {}
+
+SpawnMap::SpawnMap(const Terrain& terrain)
+    : xSize{terrain.getXSize()},
+      ySize{terrain.getYSize()},
+      wordsPerRow{(terrain.getXSize() + 63) / 64},
+      reach(terrain.getXSize() * terrain.getYSize()),
+      bits(wordsPerRow * terrain.getYSize()),
+      count{0} {
+	for (std::size_t x = 0; x < xSize; x++) updateColumn(terrain, x);
+	if (xSize != 0 && ySize != 0) updateCenters(0, 0, xSize - 1, ySize - 1);
+}
+
+void SpawnMap::update(const Terrain& terrain, const std::size_t x1, const std::size_t x2) {
+	// Changing a cell changes the runs it was or is part of, which can reach past the changed rows
+	std::size_t minY = ySize, maxY = 0;
+	for (std::size_t x = x1; x <= x2; x++) {
+		const auto changed = updateColumn(terrain, x);
+		if (!changed) continue;
+		minY = std::min(minY, changed->first);
+		maxY = std::max(maxY, changed->second);
+	}
+	if (minY > maxY) return;
+
+	// Centers up to minSpace - 1 columns away have these columns inside their circle
+	updateCenters(x1 >= minSpace - 1 ? x1 - (minSpace - 1) : 0, minY, x2 + minSpace - 1, maxY);
+}
+
+std::optional<std::pair<std::size_t, std::size_t>> SpawnMap::sample(std::mt19937& randGen) const {
+	if (count == 0) return std::nullopt;
+	std::size_t left = std::uniform_int_distribution<std::size_t>{0, count - 1}(randGen);
+
+	for (std::size_t i = 0; i < bits.size(); i++) {
+		std::uint64_t word = bits[i];
+		const std::size_t inWord = std::popcount(word);
+		if (left >= inWord) {
+			left -= inWord;
+			continue;
+		}
+
+		for (; left > 0; left--) word &= word - 1;  // Clear the lowest set bits before it
+		const std::size_t x = (i % wordsPerRow) * 64 + std::countr_zero(word);
+		return std::make_pair(x, i / wordsPerRow);
+	}
+	return std::nullopt;  // Unreachable while count is correct
+}
+
+std::optional<std::pair<std::size_t, std::size_t>> SpawnMap::updateColumn(const Terrain& terrain,
+                                                                          const std::size_t x) {
+	// Length of the empty run going up from each cell, then the smallest of that and down
+	std::vector<std::uint16_t> up(ySize);
+	for (std::size_t y = 0; y < ySize; y++)
+		up[y] = terrain.map[y][x] ? 0 : (y > 0 ? up[y - 1] : 0) + 1;
+
+	std::size_t minY = ySize, maxY = 0;
+	std::uint16_t down = 0;
+	for (std::size_t y = ySize; y-- > 0;) {
+		down = terrain.map[y][x] ? 0 : down + 1;
+		const std::uint16_t value = std::min(up[y], down);
+		std::uint16_t& current = reach[y * xSize + x];
+		if (current == value) continue;
+
+		current = value;
+		minY = std::min(minY, y);
+		maxY = std::max(maxY, y);
+	}
+	if (minY > maxY) return std::nullopt;
+	return std::make_pair(minY, maxY);
+}
+
+void SpawnMap::updateCenters(std::size_t x1, std::size_t y1, std::size_t x2, std::size_t y2) {
+	if (xSize <= 2 * minSpace || ySize <= 2 * minSpace) return;  // The circle never fits
+	x1 = std::max<std::size_t>(x1, minSpace);
+	y1 = std::max<std::size_t>(y1, minSpace);
+	x2 = std::min(x2, xSize - minSpace - 1);
+	y2 = std::min(y2, ySize - minSpace - 1);
+
+	for (std::size_t y = y1; y <= y2; y++) {
+		for (std::size_t x = x1; x <= x2; x++) {
+			std::uint64_t& word = bits[y * wordsPerRow + x / 64];
+			const std::uint64_t mask = std::uint64_t{1} << (x % 64);
+			const bool before = word & mask;
+			const bool after = fits(x, y);
+			if (before == after) continue;
+
+			word ^= mask;
+			if (after)
+				count++;
+			else
+				count--;
+		}
+	}
+}
+
+bool SpawnMap::fits(const std::size_t x, const std::size_t y) const {
+	const std::uint16_t* row = reach.data() + y * xSize + x;
+	// Middle column first, it is the tallest
+	for (int dx = 0; dx < minSpace; dx++) {
+		if (row[dx] <= circleY[dx] || row[-dx] <= circleY[dx]) return false;
+	}
+	return true;
+}
@@ -10,6 +10,19 @@ Terrain::Terrain(const std::vector<std::vector<unsigned char>>& map) : map{map}
 
 Terrain::Terrain(std::vector<std::vector<unsigned char>>&& map) : map{map} {}
 
+std::uint64_t Terrain::getHash() const {
+	std::uint64_t hash = 0xcbf29ce484222325;
+	auto add = [&hash](const std::uint64_t value) {
+		hash ^= value;
+		hash *= 0x100000001b3;
+	};
+	add(getXSize());
+	add(getYSize());
+	for (const auto& row : map)
+		for (const unsigned char cell : row) add(cell);
+	return hash;
+}
+
 void Terrain::printTerrain() const {
 	for (size_t y = 0; y < getYSize(); y++) {
 		for (size_t x = 0; x < getXSize(); x++) std::cout << (map[y][x] ? '#' : '.');
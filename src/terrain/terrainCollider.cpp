@@ -14,28 +14,17 @@ constexpr float collisionCheckRadius = 500.0f;
 TerrainCollider::TerrainCollider(Vec2&& position, Vec2&& start, Vec2&& end, Chunk& chunk)
     : chunk{chunk},
       LineCollider{Collision::Line{std::move(position), std::move(start), std::move(end)},
-                   collisionCheckRadius},
-#ifdef DEBUG_GIZMO
-      fakeObject{std::make_unique<GameObject>()}
-#else
-      fakeObject{nullptr}
-#endif
-{
-}
+                   collisionCheckRadius} {}
 
 void TerrainCollider::update(Scene& scene) {
 	LineCollider::checkCollisions(scene);
 
 #ifdef DEBUG_GIZMO
-	scene.getGame().getRenderManager().addRenderCall(
-	    [this](Scene& scene) {
-		    const Vec2& camPos = scene.getCam().getPos();
-		    SDL_SetRenderDrawColor(scene.getGame().getRenderer(), 0, 255, 255, 255);
-		    SDL_RenderDrawLine(scene.getGame().getRenderer(), line.start.x - camPos.x,
-		                       line.start.y - camPos.y, line.end.x - camPos.x,
-		                       line.end.y - camPos.y);
-	    },
-	    fakeObject.get());
+	const Vec2& camPos = scene.getCam().getPos();
+	scene.getGame().getRenderManager().addLine(
+	    SDL_FPoint{line.start.x - camPos.x, line.start.y - camPos.y},
+	    SDL_FPoint{line.end.x - camPos.x, line.end.y - camPos.y}, SDL_Color{0, 255, 255, 255},
+	    RenderManager::debugLayer);
 #endif
 }
 
@@ -1,11 +1,16 @@
 #include "terrain/terrainGenerator.h"
 
 #include <algorithm>
+#include <array>
 #include <cassert>
 #include <cstdlib>
 #include <functional>
 #include <random>
 
+#include "engine/threadPool.h"
+#include "engine/timing.h"
+#include "terrain/wallCounter.h"
+
 TerrainGenerator::TerrainGenerator(std::mt19937& randGen)
     : randGen{randGen},
       shapeFillProb{0.5},
@@ -27,16 +32,19 @@ TerrainGenerator::TerrainGenerator(std::mt19937& randGen)
       edgeThickness{50} {}
 
 Terrain TerrainGenerator::generateTerrain(const std::size_t xSize, const std::size_t ySize,
-                                          const std::size_t shapeSize) {
+                                          const std::size_t shapeSize, StageTimings* timings) {
 	assert(xSize % shapeSize == 0 && ySize % shapeSize == 0 &&
 	       "shapeSize must divide xSize and ySize.");
 
 	blockSize = shapeSize;
 
-	Terrain shape = generateShape(xSize / shapeSize, ySize / shapeSize);
-	Terrain corners = generateCorners(shape);
-	Terrain edges = addEdges(corners);
-	Terrain details = generateDetails(edges);
+	StageTimings unused;
+	StageTimings& stages = timings ? *timings : unused;
+	Terrain shape = Timing::timed(
+	    stages.shape, [&] { return generateShape(xSize / shapeSize, ySize / shapeSize); });
+	Terrain corners = Timing::timed(stages.corners, [&] { return generateCorners(shape); });
+	Terrain edges = Timing::timed(stages.edges, [&] { return addEdges(corners); });
+	Terrain details = Timing::timed(stages.details, [&] { return generateDetails(edges); });
 	return details;
 }
 
@@ -53,7 +61,9 @@ Terrain TerrainGenerator::generateShape(const std::size_t xSize, const std::size
 	}
 
 	// Calculate the entire terrain per generation
-	auto calc = std::bind_front(&TerrainGenerator::calculateShape, this);
+	auto calc = [this](const std::size_t x, const std::size_t y, const Terrain& terrain) {
+		return calculateShape(x, y, terrain);
+	};
 	for (int gen = 0; gen < shapeGenerations; gen++) {
 		Terrain curTerrain = terrain;
 		calculateArea(0, 0, xSize - 1, ySize - 1, terrain, curTerrain, calc);
@@ -358,3 +368,393 @@ TerrainGenerator::Neighbors TerrainGenerator::getNeighbors(const std::size_t x,
 	result.left = x > 0 && terrain.map[y][x - 1];
 	return result;
 }
+
+//----- PARALLEL GENERATION -----//
+
+Terrain TerrainGenerator::generateTerrain(const std::size_t xSize, const std::size_t ySize,
+                                          const std::size_t shapeSize, const std::uint32_t seed,
+                                          ThreadPool& pool, StageTimings* timings) const {
+	assert(xSize % shapeSize == 0 && ySize % shapeSize == 0 &&
+	       "shapeSize must divide xSize and ySize.");
+
+	StageTimings unused;
+	StageTimings& stages = timings ? *timings : unused;
+	const Region shapeRegion{0, 0, xSize / shapeSize, ySize / shapeSize};
+	const CellGrid shape =
+	    Timing::timed(stages.shape, [&] { return generateShape(shapeRegion, seed, pool); });
+	const CellGrid corners = Timing::timed(stages.corners, [&] {
+		return generateCorners(shape, shapeRegion, Region{0, 0, xSize, ySize}, shapeSize, seed,
+		                       pool);
+	});
+	CellGrid details = Timing::timed(stages.edges, [&] { return addEdges(corners, pool); });
+	Timing::timed(stages.details, [&] { generateDetails(details, pool); });
+	return details.toTerrain();
+}
+
+TerrainGenerator::StageTimings& TerrainGenerator::StageTimings::operator+=(
+    const StageTimings& other) {
+	shape += other.shape;
+	corners += other.corners;
+	edges += other.edges;
+	details += other.details;
+	return *this;
+}
+
+CellGrid TerrainGenerator::generateRegion(const std::size_t x, const std::size_t y,
+                                          const std::size_t xSize, const std::size_t ySize,
+                                          const std::size_t shapeSize, const std::uint32_t seed,
+                                          ThreadPool& pool) const {
+	// Every stage clips its neighbourhoods at the edges of its grid. Each stage is therefore
+	// calculated with an apron around the region, as wide as the distance the clipped values can
+	// spread, so the cells that are kept never depend on where the region starts.
+	const std::size_t cellApron =
+	    cornerGenerations * cornerCalcRange + detailsGenerations * detailsCalcRange;
+	const Region cornerRegion = expand(Region{x, y, xSize, ySize}, cellApron);
+
+	// The walls look at the neighbours of cells within their range, and the corners of a block
+	// depend on the blocks next to it.
+	const std::size_t shapeApron =
+	    shapeGenerations * std::max(shapeCalcCloseRange, shapeCalcFarRange) +
+	    shapeConsecutiveWallRange + 2;
+	const std::size_t shapeX = cornerRegion.x / shapeSize;
+	const std::size_t shapeY = cornerRegion.y / shapeSize;
+	const Region shapeRegion = expand(
+	    Region{shapeX, shapeY,
+	           (cornerRegion.x + cornerRegion.xSize + shapeSize - 1) / shapeSize - shapeX,
+	           (cornerRegion.y + cornerRegion.ySize + shapeSize - 1) / shapeSize - shapeY},
+	    shapeApron);
+
+	const CellGrid shape = generateShape(shapeRegion, seed, pool);
+	CellGrid corners = generateCorners(shape, shapeRegion, cornerRegion, shapeSize, seed, pool);
+	generateDetails(corners, pool);
+
+	// Cut away the apron
+	CellGrid result{xSize, ySize};
+	const std::size_t offsetX = x - cornerRegion.x;
+	for (std::size_t row = 0; row < ySize; row++) {
+		const unsigned char* src = corners.row(row + y - cornerRegion.y) + offsetX;
+		std::copy(src, src + xSize, result.row(row));
+	}
+	return result;
+}
+
+Terrain TerrainGenerator::generateChunk(const std::size_t chunkX, const std::size_t chunkY,
+                                        const std::size_t chunkSize, const std::size_t worldXSize,
+                                        const std::size_t worldYSize, const std::size_t shapeSize,
+                                        const std::uint32_t seed, ThreadPool& pool) const {
+	const std::size_t startX = chunkX * chunkSize;
+	const std::size_t startY = chunkY * chunkSize;
+	Terrain terrain =
+	    generateRegion(startX, startY, chunkSize, chunkSize, shapeSize, seed, pool).toTerrain();
+
+	// Fill the edges of the world
+	const std::size_t edge = edgeThickness;
+	for (std::size_t y = 0; y < chunkSize; y++) {
+		const bool edgeRow = startY + y < edge || startY + y >= worldYSize - edge;
+		for (std::size_t x = 0; x < chunkSize; x++) {
+			if (edgeRow || startX + x < edge || startX + x >= worldXSize - edge)
+				terrain.map[y][x] = 1;
+		}
+	}
+	return terrain;
+}
+
+std::uint64_t TerrainGenerator::getParameterHash() const {
+	// FNV-1a over the parameters
+	std::uint64_t hash = 0xcbf29ce484222325;
+	auto add = [&hash](const auto value) {
+		const auto* bytes = reinterpret_cast<const unsigned char*>(&value);
+		for (std::size_t i = 0; i < sizeof(value); i++) {
+			hash ^= bytes[i];
+			hash *= 0x100000001b3;
+		}
+	};
+	add(shapeFillProb);
+	add(shapeGenerations);
+	add(shapeConsecutiveWallRange);
+	add(shapeMinConsecutiveWall);
+	add(shapeWallRandomness);
+	add(shapeCalcCloseRange);
+	add(shapeCalcFarRange);
+	add(shapeCalcMinCloseFill);
+	add(shapeCalcMaxFarFill);
+	add(cornerFillProb);
+	add(cornerGenerations);
+	add(cornerCalcRange);
+	add(cornerCalcMinFill);
+	add(detailsGenerations);
+	add(detailsCalcRange);
+	add(detailsCalcMinFill);
+	add(edgeThickness);
+	return hash;
+}
+
+TerrainGenerator::Region TerrainGenerator::expand(const Region& region, const std::size_t amount) {
+	// Clamped at the start of the world, which is the same for every region touching it
+	const std::size_t x = region.x >= amount ? region.x - amount : 0;
+	const std::size_t y = region.y >= amount ? region.y - amount : 0;
+	return Region{x, y, region.x + region.xSize + amount - x, region.y + region.ySize + amount - y};
+}
+
+double TerrainGenerator::cellRandom(const std::uint32_t seed, const RandomStage stage,
+                                    const std::size_t x, const std::size_t y) {
+	// SplitMix64 finalizer
+	auto mix = [](std::uint64_t z) {
+		z += 0x9e3779b97f4a7c15;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+		return z ^ (z >> 31);
+	};
+	std::uint64_t hash = mix((static_cast<std::uint64_t>(stage) << 32) | seed);
+	hash = mix(hash ^ x);
+	hash = mix(hash ^ y);
+	return (hash >> 11) * 0x1.0p-53;  // Top 53 bits as a double in [0, 1)
+}
+
+void TerrainGenerator::forEachTile(const std::size_t xSize, const std::size_t ySize,
+                                   ThreadPool& pool,
+                                   const std::function<void(const Tile&)>& func) const {
+	const std::size_t tilesX = (xSize + tileSize - 1) / tileSize;
+	const std::size_t tilesY = (ySize + tileSize - 1) / tileSize;
+
+	pool.parallelFor(tilesX * tilesY, [&](const std::size_t i) {
+		const std::size_t tileX = i % tilesX;
+		const std::size_t tileY = i / tilesX;
+		const Tile tile{tileX * tileSize,
+		                tileY * tileSize,
+		                std::min((tileX + 1) * tileSize, xSize),
+		                std::min((tileY + 1) * tileSize, ySize)};
+		func(tile);
+	});
+}
+
+template <class Rule>
+void TerrainGenerator::calculateGenerations(CellGrid& grid, const int generations,
+                                            ThreadPool& pool, const Rule& rule) const {
+	if (generations <= 0) return;
+
+	CellGrid next{grid.xSize, grid.ySize};
+	for (int gen = 0; gen < generations; gen++) {
+		const WallCounter counter{grid};
+		forEachTile(grid.xSize, grid.ySize, pool, [&](const Tile& tile) {
+			for (std::size_t y = tile.y1; y < tile.y2; y++)
+				rule(tile, y, grid, counter, next.row(y));
+		});
+		std::swap(grid, next);
+	}
+}
+
+CellGrid TerrainGenerator::generateShape(const Region& region, const std::uint32_t seed,
+                                         ThreadPool& pool) const {
+	CellGrid terrain{region.xSize, region.ySize};
+
+	// Fill entire terrain randomly
+	forEachTile(region.xSize, region.ySize, pool, [&](const Tile& tile) {
+		for (std::size_t y = tile.y1; y < tile.y2; y++) {
+			for (std::size_t x = tile.x1; x < tile.x2; x++) {
+				terrain.at(x, y) =
+				    cellRandom(seed, RandomStage::SHAPE_FILL, region.x + x, region.y + y) <=
+				    shapeFillProb;
+			}
+		}
+	});
+
+	calculateGenerations(terrain, shapeGenerations, pool,
+	                     [this](const Tile& tile, const std::size_t y, const CellGrid& ref,
+	                            const WallCounter& counter, unsigned char* out) {
+		                     calculateShape(tile, y, ref, counter, out);
+	                     });
+
+	CellGrid result{terrain};
+	forEachTile(region.xSize, region.ySize, pool, [&](const Tile& tile) {
+		for (std::size_t y = tile.y1; y < tile.y2; y++) {
+			for (std::size_t x = tile.x1; x < tile.x2; x++) {
+				if (x == 0 || y == 0 || x == region.xSize - 1 || y == region.ySize - 1) continue;
+				const double randomValue =
+				    cellRandom(seed, RandomStage::SHAPE_WALLS, region.x + x, region.y + y);
+				result.at(x, y) = randomizeConsecutiveWall(
+				    x, y, shapeConsecutiveWallRange, shapeMinConsecutiveWall, shapeWallRandomness,
+				    randomValue, terrain);
+			}
+		}
+	});
+
+	return result;
+}
+
+void TerrainGenerator::calculateShape(const Tile& tile, const std::size_t y,
+                                      const CellGrid& terrain, const WallCounter& counter,
+                                      unsigned char* out) const {
+	const std::size_t width = tile.x2 - tile.x1;
+	std::array<int, tileSize> wallsClose;
+	std::array<int, tileSize> wallsFar;
+	counter.countRow(y, shapeCalcCloseRange, tile.x1, tile.x2, wallsClose.data());
+	counter.countRow(y, shapeCalcFarRange, tile.x1, tile.x2, wallsFar.data());
+
+	const unsigned char* cells = terrain.row(y) + tile.x1;
+	for (std::size_t i = 0; i < width; i++) {
+		// The counts include the middle cell
+		const int close = wallsClose[i] - cells[i];
+		const int far = wallsFar[i] - cells[i];
+		out[tile.x1 + i] = close >= shapeCalcMinCloseFill || far <= shapeCalcMaxFarFill;
+	}
+}
+
+CellGrid TerrainGenerator::generateCorners(const CellGrid& shape, const Region& shapeRegion,
+                                           const Region& region, const std::size_t shapeSize,
+                                           const std::uint32_t seed, ThreadPool& pool) const {
+	const std::vector<std::vector<Corner>> shapeCorners = checkCorners(shape.toTerrain());
+
+	CellGrid terrain{region.xSize, region.ySize};
+	CellGrid cornerMask{terrain.xSize, terrain.ySize};
+
+	// Copy the shape blocks, and fill their corners randomly
+	forEachTile(terrain.xSize, terrain.ySize, pool, [&](const Tile& tile) {
+		for (std::size_t y = tile.y1; y < tile.y2; y++) {
+			for (std::size_t x = tile.x1; x < tile.x2; x++) {
+				const std::size_t worldX = region.x + x;
+				const std::size_t worldY = region.y + y;
+				cornerMask.at(x, y) =
+				    isInCorner(worldX, worldY, shapeRegion, shapeCorners, shapeSize);
+				if (cornerMask.at(x, y)) {
+					terrain.at(x, y) =
+					    cellRandom(seed, RandomStage::CORNER_FILL, worldX, worldY) <=
+					    cornerFillProb;
+				} else {
+					terrain.at(x, y) = shape.at(worldX / shapeSize - shapeRegion.x,
+					                            worldY / shapeSize - shapeRegion.y);
+				}
+			}
+		}
+	});
+
+	calculateGenerations(
+	    terrain, cornerGenerations, pool,
+	    [this, &cornerMask](const Tile& tile, const std::size_t y, const CellGrid& ref,
+	                        const WallCounter& counter, unsigned char* out) {
+		    std::array<int, tileSize> walls;
+		    counter.countRow(y, cornerCalcRange, tile.x1, tile.x2, walls.data());
+
+		    const unsigned char* cells = ref.row(y);
+		    const unsigned char* mask = cornerMask.row(y);
+		    for (std::size_t x = tile.x1; x < tile.x2; x++) {
+			    const bool fill = walls[x - tile.x1] - cells[x] >= cornerCalcMinFill;
+			    out[x] = mask[x] ? fill : cells[x];
+		    }
+	    });
+
+	return terrain;
+}
+
+bool TerrainGenerator::isInCorner(const std::size_t x, const std::size_t y,
+                                  const Region& shapeRegion,
+                                  const std::vector<std::vector<Corner>>& shapeCorners,
+                                  const std::size_t shapeSize) const {
+	const Corner& corner =
+	    shapeCorners[y / shapeSize - shapeRegion.y][x / shapeSize - shapeRegion.x];
+	const std::size_t localX = x % shapeSize;
+	const std::size_t localY = y % shapeSize;
+	const std::size_t mid = shapeSize / 2;
+
+	// Same areas as the BlockPositions used by the serial generator, mid is part of both halves
+	return (corner.topRight && localX >= mid && localY <= mid) ||
+	       (corner.botRight && localX >= mid && localY >= mid) ||
+	       (corner.botLeft && localX <= mid && localY >= mid) ||
+	       (corner.topLeft && localX <= mid && localY <= mid);
+}
+
+CellGrid TerrainGenerator::addEdges(const CellGrid& reference, ThreadPool& pool) const {
+	CellGrid terrain{reference.xSize + edgeThickness * 2, reference.ySize + edgeThickness * 2};
+
+	forEachTile(terrain.xSize, terrain.ySize, pool, [&](const Tile& tile) {
+		for (std::size_t y = tile.y1; y < tile.y2; y++) {
+			for (std::size_t x = tile.x1; x < tile.x2; x++) {
+				if (x < edgeThickness || y < edgeThickness ||
+				    x >= terrain.xSize - edgeThickness - 1 || y >= terrain.ySize - edgeThickness)
+					terrain.at(x, y) = 1;
+				else
+					terrain.at(x, y) = reference.at(x - edgeThickness, y - edgeThickness);
+			}
+		}
+	});
+
+	return terrain;
+}
+
+void TerrainGenerator::generateDetails(CellGrid& terrain, ThreadPool& pool) const {
+	calculateGenerations(
+	    terrain, detailsGenerations, pool,
+	    [this](const Tile& tile, const std::size_t y, const CellGrid& ref,
+	           const WallCounter& counter, unsigned char* out) {
+		    std::array<int, tileSize> walls;
+		    counter.countRow(y, detailsCalcRange, tile.x1, tile.x2, walls.data());
+
+		    const unsigned char* cells = ref.row(y);
+		    for (std::size_t x = tile.x1; x < tile.x2; x++)
+			    out[x] = walls[x - tile.x1] - cells[x] >= detailsCalcMinFill;
+	    });
+}
+
+unsigned char TerrainGenerator::randomizeConsecutiveWall(const std::size_t x, const std::size_t y,
+                                                         const int range, const int wallLength,
+                                                         const double prob,
+                                                         const double randomValue,
+                                                         const CellGrid& terrain) const {
+	auto checkVertical = [&terrain, x, this](const long y) -> bool {
+		const auto [above, right, below, left] = getNeighbors(x, y, terrain);
+		return ((above && below) && (left != right));
+	};
+	// Signed positions, so that ranges going past the start of the terrain are clamped correctly
+	const long signedX = x;
+	const long signedY = y;
+
+	int vertical = 0;
+	for (long v = signedY; v >= std::max(signedY - range, 1L); v--) {
+		if (checkVertical(v))
+			++vertical;
+		else
+			break;
+	}
+	const long maxY = terrain.ySize - 2;
+	for (long v = signedY + 1; v <= std::min(signedY + range, maxY); v++) {
+		if (checkVertical(v))
+			++vertical;
+		else
+			break;
+	}
+
+	if (vertical >= wallLength) return randomValue <= prob;
+
+	auto checkHorizontal = [&terrain, y, this](const long x) -> bool {
+		auto [above, right, below, left] = getNeighbors(x, y, terrain);
+		return ((left && right) && (above != below));
+	};
+	int horizontal = 0;
+	for (long h = signedX; h >= std::max(signedX - range, 1L); h--) {
+		if (checkHorizontal(h))
+			++horizontal;
+		else
+			break;
+	}
+	const long maxX = terrain.xSize - 2;
+	for (long h = signedX + 1; h <= std::min(signedX + range, maxX); h++) {
+		if (checkHorizontal(h))
+			++horizontal;
+		else
+			break;
+	}
+
+	if (horizontal >= wallLength) return randomValue <= prob;
+
+	return terrain.at(x, y);
+}
+
+TerrainGenerator::Neighbors TerrainGenerator::getNeighbors(const std::size_t x, const std::size_t y,
+                                                           const CellGrid& terrain) const {
+	Neighbors result;
+	result.above = y > 0 && terrain.at(x, y - 1);
+	result.below = y < terrain.ySize - 1 && terrain.at(x, y + 1);
+	result.right = x < terrain.xSize - 1 && terrain.at(x + 1, y);
+	result.left = x > 0 && terrain.at(x - 1, y);
+	return result;
+}
@@ -0,0 +1,128 @@
+#include "terrain/terrainShapes.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace {
+void addSpan(const std::ptrdiff_t y, std::ptrdiff_t x1, std::ptrdiff_t x2,
+             const unsigned char value, const std::size_t xSize, const std::size_t ySize,
+             std::vector<TerrainSpan>& spans) {
+	x1 = std::max<std::ptrdiff_t>(x1, 0);
+	x2 = std::min<std::ptrdiff_t>(x2, xSize - 1);
+	if (y < 0 || y >= static_cast<std::ptrdiff_t>(ySize) || x1 > x2) return;
+	spans.push_back(TerrainSpan{static_cast<std::size_t>(y), static_cast<std::size_t>(x1),
+	                            static_cast<std::size_t>(x2) + 1, value});
+}
+
+// Half widths of the rows 0 to radius, from the stencils when the circle is small enough.
+std::vector<std::int16_t> halfWidths(const int radius) {
+	if (radius <= TerrainShapes::maxStencilRadius) {
+		const TerrainShapes::Stencil& stencil = TerrainShapes::circleStencils[radius];
+		return std::vector<std::int16_t>(stencil.begin(), stencil.begin() + radius + 1);
+	}
+	std::vector<std::int16_t> widths(radius + 1);
+	for (int dy = 0; dy <= radius; dy++) widths[dy] = TerrainShapes::circleHalfWidth(radius, dy);
+	return widths;
+}
+}  // namespace
+
+void TerrainShapes::circle(const std::ptrdiff_t centerX, const std::ptrdiff_t centerY,
+                           const int radius, const unsigned char value, const std::size_t xSize,
+                           const std::size_t ySize, std::vector<TerrainSpan>& spans) {
+	if (radius < 0) return;
+	const std::vector<std::int16_t> widths = halfWidths(radius);
+	for (int dy = -radius; dy <= radius; dy++) {
+		const int width = widths[std::abs(dy)];
+		addSpan(centerY + dy, centerX - width, centerX + width, value, xSize, ySize, spans);
+	}
+}
+
+void TerrainShapes::rectangle(std::ptrdiff_t x1, std::ptrdiff_t y1, std::ptrdiff_t x2,
+                              std::ptrdiff_t y2, const unsigned char value,
+                              const std::size_t xSize, const std::size_t ySize,
+                              std::vector<TerrainSpan>& spans) {
+	if (x1 > x2) std::swap(x1, x2);
+	if (y1 > y2) std::swap(y1, y2);
+	y1 = std::max<std::ptrdiff_t>(y1, 0);
+	y2 = std::min<std::ptrdiff_t>(y2, ySize - 1);
+	for (std::ptrdiff_t y = y1; y <= y2; y++) addSpan(y, x1, x2, value, xSize, ySize, spans);
+}
+
+void TerrainShapes::capsule(const std::ptrdiff_t startX, const std::ptrdiff_t startY,
+                            const std::ptrdiff_t endX, const std::ptrdiff_t endY,
+                            const int radius, const unsigned char value, const std::size_t xSize,
+                            const std::size_t ySize, std::vector<TerrainSpan>& spans) {
+	if (radius < 0) return;
+	const std::vector<std::int16_t> widths = halfWidths(radius);
+
+	// The circle stamped at every cell along the line, merged into one range per row
+	const std::ptrdiff_t top = std::min(startY, endY) - radius;
+	const std::ptrdiff_t rows = std::abs(endY - startY) + 2 * radius + 1;
+	std::vector<std::ptrdiff_t> left(rows, PTRDIFF_MAX), right(rows, PTRDIFF_MIN);
+	const std::ptrdiff_t steps = std::max(std::abs(endX - startX), std::abs(endY - startY));
+	for (std::ptrdiff_t step = 0; step <= steps; step++) {
+		const double t = steps == 0 ? 0 : static_cast<double>(step) / steps;
+		const std::ptrdiff_t x = std::lround(startX + (endX - startX) * t);
+		const std::ptrdiff_t y = std::lround(startY + (endY - startY) * t);
+		for (int dy = -radius; dy <= radius; dy++) {
+			const std::ptrdiff_t row = y + dy - top;
+			left[row] = std::min<std::ptrdiff_t>(left[row], x - widths[std::abs(dy)]);
+			right[row] = std::max<std::ptrdiff_t>(right[row], x + widths[std::abs(dy)]);
+		}
+	}
+
+	for (std::ptrdiff_t row = 0; row < rows; row++)
+		addSpan(top + row, left[row], right[row], value, xSize, ySize, spans);
+}
+
+std::vector<TerrainSpan> TerrainShapes::coalesce(const std::span<const TerrainSpan> spans) {
+	// Rows in order, and the latest span first within a row
+	std::vector<std::size_t> order(spans.size());
+	for (std::size_t i = 0; i < order.size(); i++) order[i] = i;
+	std::sort(order.begin(), order.end(), [&spans](const std::size_t a, const std::size_t b) {
+		return spans[a].y != spans[b].y ? spans[a].y < spans[b].y : a > b;
+	});
+
+	std::vector<TerrainSpan> result;
+	// Parts of the row already covered by later spans, sorted and not overlapping
+	std::vector<std::pair<std::size_t, std::size_t>> covered;
+	for (std::size_t i = 0; i < order.size(); i++) {
+		const TerrainSpan& span = spans[order[i]];
+		if (i == 0 || spans[order[i - 1]].y != span.y) covered.clear();
+
+		// Emit the parts of span between the covered parts
+		std::size_t x = span.x1;
+		auto it = std::lower_bound(covered.begin(), covered.end(), std::make_pair(x, x),
+		                           [](const auto& a, const auto& b) { return a.second < b.first; });
+		for (auto part = it; part != covered.end() && part->first < span.x2; ++part) {
+			if (x < part->first) result.push_back(TerrainSpan{span.y, x, part->first, span.value});
+			x = std::max(x, part->second);
+		}
+		if (x < span.x2) result.push_back(TerrainSpan{span.y, x, span.x2, span.value});
+
+		// Cover the span, joining the parts it touches
+		std::size_t start = span.x1, end = span.x2;
+		auto last = it;
+		while (last != covered.end() && last->first <= end) {
+			start = std::min(start, last->first);
+			end = std::max(end, last->second);
+			++last;
+		}
+		it = covered.erase(it, last);
+		covered.insert(it, std::make_pair(start, end));
+	}
+
+	// Pieces of the same row next to each other with the same value become one
+	std::sort(result.begin(), result.end(), [](const TerrainSpan& a, const TerrainSpan& b) {
+		return a.y != b.y ? a.y < b.y : a.x1 < b.x1;
+	});
+	std::vector<TerrainSpan> merged;
+	for (const TerrainSpan& span : result) {
+		if (!merged.empty() && merged.back().y == span.y && merged.back().x2 == span.x1 &&
+		    merged.back().value == span.value)
+			merged.back().x2 = span.x2;
+		else
+			merged.push_back(span);
+	}
+	return merged;
+}
@@ -0,0 +1,147 @@
+#include "terrain/terrainStore.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace {
+constexpr std::size_t initialPages = 16;
+
+std::size_t alignUp(const std::size_t bytes) { return (bytes + 7) & ~std::size_t{7}; }
+std::size_t tableSize(const std::size_t chunksX, const std::size_t chunksY) {
+	return alignUp(chunksX * chunksY * sizeof(std::uint32_t));
+}
+std::size_t pageSize(const std::size_t chunkSize) {
+	return alignUp((chunkSize * chunkSize + 7) / 8);
+}
+}  // namespace
+
+TerrainStore::TerrainStore(const std::string& path, const std::size_t chunkSize,
+                           const std::size_t chunksX, const std::size_t chunksY,
+                           const std::size_t residentLimit)
+    : file{path, tableSize(chunksX, chunksY) + initialPages * pageSize(chunkSize)},
+      path{path},
+      chunkSize{chunkSize},
+      chunksX{chunksX},
+      chunksY{chunksY},
+      residentLimit{std::max<std::size_t>(1, residentLimit)},
+      tableBytes{tableSize(chunksX, chunksY)},
+      pageBytes{pageSize(chunkSize)},
+      pageCount{0},
+      pageCapacity{initialPages} {
+	if (!file.isOpen()) {
+		std::cerr << "Could not create terrain store " << path << '\n';
+		throw 1;
+	}
+}
+
+TerrainStore::~TerrainStore() {
+	if (path.empty()) return;  // Moved from
+	// Unmap first, the file can not be removed while it is mapped on every platform
+	{ MappedFile closing = std::move(file); }
+	std::remove(path.c_str());
+}
+
+TerrainStore::TerrainStore(TerrainStore&& other) noexcept
+    : file{std::move(other.file)},
+      path{std::exchange(other.path, {})},
+      chunkSize{other.chunkSize},
+      chunksX{other.chunksX},
+      chunksY{other.chunksY},
+      residentLimit{other.residentLimit},
+      tableBytes{other.tableBytes},
+      pageBytes{other.pageBytes},
+      pageCount{other.pageCount},
+      pageCapacity{other.pageCapacity},
+      resident{std::move(other.resident)},
+      lru{std::move(other.lru)} {}
+
+bool TerrainStore::contains(const std::size_t x, const std::size_t y) const {
+	assert(x < chunksX && y < chunksY && "Chunk position must be inside the world.");
+	const std::size_t index = chunkIndex(x, y);
+	return table()[index] != 0 || resident.contains(index);
+}
+
+const Terrain& TerrainStore::load(const std::size_t x, const std::size_t y) {
+	assert(contains(x, y) && "Chunk must be stored before it is loaded.");
+	const std::size_t index = chunkIndex(x, y);
+
+	auto it = resident.find(index);
+	if (it != resident.end()) {
+		lru.splice(lru.begin(), lru, it->second.lruPos);
+		return it->second.terrain;
+	}
+
+	makeRoom();
+	lru.push_front(index);
+	return resident.emplace(index, Resident{readPage(index), false, lru.begin()})
+	    .first->second.terrain;
+}
+
+void TerrainStore::store(const std::size_t x, const std::size_t y, Terrain&& terrain) {
+	assert(x < chunksX && y < chunksY && "Chunk position must be inside the world.");
+	assert(terrain.getXSize() == chunkSize && terrain.getYSize() == chunkSize);
+	const std::size_t index = chunkIndex(x, y);
+
+	auto it = resident.find(index);
+	if (it != resident.end()) {
+		it->second.terrain = std::move(terrain);
+		it->second.dirty = true;
+		lru.splice(lru.begin(), lru, it->second.lruPos);
+		return;
+	}
+
+	makeRoom();
+	lru.push_front(index);
+	resident.emplace(index, Resident{std::move(terrain), true, lru.begin()});
+}
+
+void TerrainStore::makeRoom() {
+	while (resident.size() >= residentLimit) {
+		const std::size_t index = lru.back();
+		lru.pop_back();
+
+		auto it = resident.find(index);
+		if (it->second.dirty) writePage(index, it->second.terrain);
+		resident.erase(it);
+	}
+}
+
+void TerrainStore::writePage(const std::size_t index, const Terrain& terrain) {
+	if (table()[index] == 0) {
+		if (pageCount == pageCapacity) {
+			if (!file.resize(tableBytes + 2 * pageCapacity * pageBytes)) {
+				std::cerr << "Could not grow terrain store " << path << '\n';
+				throw 1;
+			}
+			pageCapacity *= 2;
+		}
+		table()[index] = ++pageCount;
+	}
+
+	std::byte* bits = page(table()[index] - 1);
+	std::memset(bits, 0, pageBytes);
+	std::size_t i = 0;
+	for (const auto& row : terrain.map) {
+		for (const unsigned char cell : row) {
+			if (cell) bits[i / 8] |= std::byte{1} << (i % 8);
+			i++;
+		}
+	}
+}
+
+Terrain TerrainStore::readPage(const std::size_t index) {
+	const std::byte* bits = page(table()[index] - 1);
+	Terrain terrain{chunkSize, chunkSize};
+	std::size_t i = 0;
+	for (auto& row : terrain.map) {
+		for (unsigned char& cell : row) {
+			cell = std::to_integer<unsigned char>(bits[i / 8] >> (i % 8)) & 1;
+			i++;
+		}
+	}
+	return terrain;
+}
@@ -0,0 +1,53 @@
+#include "terrain/wallCounter.h"
+
+#include <algorithm>
+
+WallCounter::WallCounter(const CellGrid& grid)
+    : xSize{grid.xSize}, ySize{grid.ySize}, table((grid.xSize + 1) * (grid.ySize + 1)) {
+	const std::size_t stride = xSize + 1;
+	for (std::size_t y = 0; y < ySize; y++) {
+		const unsigned char* cells = grid.row(y);
+		const std::uint32_t* above = table.data() + y * stride;
+		std::uint32_t* current = table.data() + (y + 1) * stride;
+
+		// Column sums, whole row at a time
+		for (std::size_t x = 0; x < xSize; x++) current[x + 1] = above[x + 1] + cells[x];
+		// Add the row prefix. The column sums are done, so subtracting above gives the cells back.
+		std::uint32_t rowSum = 0;
+		for (std::size_t x = 0; x < xSize; x++) {
+			rowSum += current[x + 1] - above[x + 1];
+			current[x + 1] = above[x + 1] + rowSum;
+		}
+	}
+}
+
+int WallCounter::count(const std::size_t x, const std::size_t y, const int range) const {
+	int result;
+	countRow(y, range, x, x + 1, &result);
+	return result;
+}
+
+void WallCounter::countRow(const std::size_t y, const int range, const std::size_t x1,
+                           const std::size_t x2, int* out) const {
+	// Rows of the table bounding the square vertically
+	const std::uint32_t* top = tableRow(y >= range ? y - range : 0);
+	const std::uint32_t* bot = tableRow(std::min(ySize - 1, y + range) + 1);
+
+	auto clipped = [top, bot, range, this](const std::size_t x) -> int {
+		const std::size_t left = x >= range ? x - range : 0;
+		const std::size_t right = std::min(xSize - 1, x + range) + 1;
+		return static_cast<int>(bot[right] - top[right]) - static_cast<int>(bot[left] - top[left]);
+	};
+
+	// The square is only unclipped horizontally for range <= x < xSize - range
+	const std::size_t midStart = std::clamp(static_cast<std::size_t>(range), x1, x2);
+	const std::size_t midEnd =
+	    std::clamp(xSize > range ? xSize - range : 0, midStart, std::max(midStart, x2));
+
+	for (std::size_t x = x1; x < midStart; x++) out[x - x1] = clipped(x);
+	for (std::size_t x = midStart; x < midEnd; x++) {
+		out[x - x1] = static_cast<int>(bot[x + range + 1] - top[x + range + 1]) -
+		              static_cast<int>(bot[x - range] - top[x - range]);
+	}
+	for (std::size_t x = midEnd; x < x2; x++) out[x - x1] = clipped(x);
+}
@@ -0,0 +1,264 @@
+#include "terrain/worldBake.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <vector>
+
+#include "engine/threadPool.h"
+#include "terrain/terrainGenerator.h"
+
+namespace {
+constexpr char magic[4] = {'T', 'D', 'S', 'W'};
+constexpr std::uint32_t byteOrderMark = 0x01020304;
+
+std::uint64_t alignUp(const std::uint64_t offset) { return (offset + 7) & ~std::uint64_t{7}; }
+
+// Everything stored for one chunk, before it is written.
+struct BakedChunk {
+	std::vector<unsigned char> terrain;
+	WorldBake::Encoding encoding;
+	std::vector<Chunk::Segment> segments;
+	std::vector<Chunk::SpawnCell> spawns;
+};
+
+std::vector<unsigned char> encodeBits(const Terrain& terrain) {
+	const std::size_t cells = terrain.getXSize() * terrain.getYSize();
+	std::vector<unsigned char> result((cells + 7) / 8);
+	std::size_t i = 0;
+	for (const auto& row : terrain.map) {
+		for (const unsigned char cell : row) {
+			if (cell) result[i / 8] |= 1 << (i % 8);
+			i++;
+		}
+	}
+	return result;
+}
+
+std::vector<unsigned char> encodeRLE(const Terrain& terrain) {
+	std::vector<std::uint16_t> runs;
+	unsigned char current = 0;
+	std::uint16_t length = 0;
+	for (const auto& row : terrain.map) {
+		for (const unsigned char cell : row) {
+			if ((cell != 0) != current) {
+				runs.push_back(length);
+				current = !current;
+				length = 0;
+			} else if (length == std::numeric_limits<std::uint16_t>::max()) {
+				// Split with an empty run of the other value
+				runs.push_back(length);
+				runs.push_back(0);
+				length = 0;
+			}
+			length++;
+		}
+	}
+	runs.push_back(length);
+
+	std::vector<unsigned char> result(runs.size() * sizeof(std::uint16_t));
+	std::memcpy(result.data(), runs.data(), result.size());
+	return result;
+}
+
+template <class T>
+void writeBlock(std::ofstream& out, const T* data, const std::size_t count) {
+	out.write(reinterpret_cast<const char*>(data), count * sizeof(T));
+	const std::uint64_t end = out.tellp();
+	const std::uint64_t padding = alignUp(end) - end;
+	constexpr char zeros[8] = {};
+	out.write(zeros, padding);
+}
+}  // namespace
+
+WorldBake::WorldBake(MappedFile&& file)
+    : file{std::move(file)},
+      header{reinterpret_cast<const Header*>(this->file.getData())},
+      entries{reinterpret_cast<const ChunkEntry*>(this->file.getData() + header->entriesOffset)} {}
+
+std::optional<WorldBake> WorldBake::open(const std::string& path) {
+	MappedFile file{path};
+	if (!file.isOpen() || file.getSize() < sizeof(Header)) return std::nullopt;
+
+	const Header* header = reinterpret_cast<const Header*>(file.getData());
+	if (std::memcmp(header->magic, magic, sizeof(magic)) != 0 || header->version != version ||
+	    header->byteOrder != byteOrderMark)
+		return std::nullopt;
+
+	const std::uint64_t entryCount = std::uint64_t{header->chunksX} * header->chunksY;
+	if (header->entriesOffset % 8 != 0 || header->entriesOffset > file.getSize() ||
+	    entryCount > (file.getSize() - header->entriesOffset) / sizeof(ChunkEntry))
+		return std::nullopt;
+
+	WorldBake bake{std::move(file)};
+	if (!bake.validate()) return std::nullopt;
+	return bake;
+}
+
+bool WorldBake::validate() const {
+	const std::uint64_t size = file.getSize();
+	auto inside = [size](const std::uint64_t offset, const std::uint64_t bytes) {
+		return offset % 8 == 0 && offset <= size && bytes <= size - offset;
+	};
+
+	const std::uint64_t cells = std::uint64_t{header->chunkSize} * header->chunkSize;
+	for (std::size_t i = 0; i < std::size_t{header->chunksX} * header->chunksY; i++) {
+		const ChunkEntry& entry = entries[i];
+		if (!inside(entry.terrainOffset, entry.terrainBytes) ||
+		    !inside(entry.segmentsOffset, entry.segmentCount * sizeof(Chunk::Segment)) ||
+		    !inside(entry.spawnsOffset, entry.spawnCount * sizeof(Chunk::SpawnCell)))
+			return false;
+		if (entry.encoding == Encoding::BITS && entry.terrainBytes != (cells + 7) / 8)
+			return false;
+		if (entry.encoding != Encoding::BITS && entry.encoding != Encoding::RLE) return false;
+	}
+	return true;
+}
+
+bool WorldBake::bake(const std::string& path, const TerrainGenerator& generator,
+                     const std::uint32_t seed, const std::size_t shapeSize,
+                     const std::size_t chunkSize, const Area& area, const bool compress,
+                     ThreadPool& pool) {
+	assert(area.firstChunkX + area.chunksX <= area.worldChunksX &&
+	       area.firstChunkY + area.chunksY <= area.worldChunksY &&
+	       "The baked area must be inside the world.");
+
+	std::ofstream out{path, std::ios::binary | std::ios::trunc};
+	if (!out) return false;
+
+	Header header{};
+	std::memcpy(header.magic, magic, sizeof(magic));
+	header.version = version;
+	header.byteOrder = byteOrderMark;
+	header.seed = seed;
+	header.key = makeKey(generator, seed, shapeSize, chunkSize, area.worldChunksX,
+	                     area.worldChunksY);
+	header.chunkSize = chunkSize;
+	header.shapeSize = shapeSize;
+	header.worldChunksX = area.worldChunksX;
+	header.worldChunksY = area.worldChunksY;
+	header.firstChunkX = area.firstChunkX;
+	header.firstChunkY = area.firstChunkY;
+	header.chunksX = area.chunksX;
+	header.chunksY = area.chunksY;
+	header.entriesOffset = sizeof(Header);
+
+	// The entries are written again at the end, when the offsets are known
+	std::vector<ChunkEntry> entries(area.chunksX * area.chunksY);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	writeBlock(out, entries.data(), entries.size());
+
+	const std::size_t worldXSize = area.worldChunksX * chunkSize;
+	const std::size_t worldYSize = area.worldChunksY * chunkSize;
+	std::vector<BakedChunk> row(area.chunksX);
+	for (std::size_t y = 0; y < area.chunksY; y++) {
+		// Generate a row of chunks at a time, and write it before starting the next
+		pool.parallelFor(area.chunksX, [&](const std::size_t x) {
+			const Terrain terrain = generator.generateChunk(
+			    area.firstChunkX + x, area.firstChunkY + y, chunkSize, worldXSize, worldYSize,
+			    shapeSize, seed, pool);
+
+			BakedChunk& chunk = row[x];
+			chunk.terrain = encodeBits(terrain);
+			chunk.encoding = Encoding::BITS;
+			if (compress) {
+				std::vector<unsigned char> rle = encodeRLE(terrain);
+				if (rle.size() < chunk.terrain.size()) {
+					chunk.terrain = std::move(rle);
+					chunk.encoding = Encoding::RLE;
+				}
+			}
+			const Chunk::Fill fill =
+			    Chunk::findFill(Chunk::countRows(terrain), terrain.getXSize());
+			chunk.segments = Chunk::findSegments(terrain, fill);
+			chunk.spawns = Chunk::findSpawnCells(terrain, fill);
+		});
+
+		for (std::size_t x = 0; x < area.chunksX; x++) {
+			const BakedChunk& chunk = row[x];
+			ChunkEntry& entry = entries[y * area.chunksX + x];
+			entry.encoding = chunk.encoding;
+			entry.terrainBytes = chunk.terrain.size();
+			entry.segmentCount = chunk.segments.size();
+			entry.spawnCount = chunk.spawns.size();
+
+			entry.terrainOffset = out.tellp();
+			writeBlock(out, chunk.terrain.data(), chunk.terrain.size());
+			entry.segmentsOffset = out.tellp();
+			writeBlock(out, chunk.segments.data(), chunk.segments.size());
+			entry.spawnsOffset = out.tellp();
+			writeBlock(out, chunk.spawns.data(), chunk.spawns.size());
+		}
+	}
+
+	out.seekp(header.entriesOffset);
+	out.write(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(ChunkEntry));
+	return static_cast<bool>(out);
+}
+
+std::uint64_t WorldBake::makeKey(const TerrainGenerator& generator, const std::uint32_t seed,
+                                 const std::size_t shapeSize, const std::size_t chunkSize,
+                                 const std::size_t worldChunksX,
+                                 const std::size_t worldChunksY) {
+	// FNV-1a, continuing from the parameter hash
+	std::uint64_t key = generator.getParameterHash();
+	for (const std::uint64_t value : {std::uint64_t{version}, std::uint64_t{seed},
+	                                  std::uint64_t{shapeSize}, std::uint64_t{chunkSize},
+	                                  std::uint64_t{worldChunksX}, std::uint64_t{worldChunksY}}) {
+		for (int byte = 0; byte < 8; byte++) {
+			key ^= (value >> (byte * 8)) & 0xff;
+			key *= 0x100000001b3;
+		}
+	}
+	return key;
+}
+
+bool WorldBake::contains(const std::size_t x, const std::size_t y) const {
+	return x >= header->firstChunkX && x - header->firstChunkX < header->chunksX &&
+	       y >= header->firstChunkY && y - header->firstChunkY < header->chunksY;
+}
+
+const WorldBake::ChunkEntry& WorldBake::getEntry(const std::size_t x, const std::size_t y) const {
+	assert(contains(x, y) && "Chunk must be in the bake.");
+	return entries[(y - header->firstChunkY) * header->chunksX + x - header->firstChunkX];
+}
+
+Terrain WorldBake::getTerrain(const std::size_t x, const std::size_t y) const {
+	const ChunkEntry& entry = getEntry(x, y);
+	const std::size_t size = header->chunkSize;
+	const std::byte* data = file.getData() + entry.terrainOffset;
+	Terrain terrain{size, size};
+
+	if (entry.encoding == Encoding::BITS) {
+		for (std::size_t i = 0; i < size * size; i++) {
+			const bool filled = (std::to_integer<unsigned>(data[i / 8]) >> (i % 8)) & 1;
+			terrain.map[i / size][i % size] = filled;
+		}
+		return terrain;
+	}
+
+	const auto* runs = reinterpret_cast<const std::uint16_t*>(data);
+	const std::size_t runCount = entry.terrainBytes / sizeof(std::uint16_t);
+	std::size_t cell = 0;
+	for (std::size_t run = 0; run < runCount && cell < size * size; run++) {
+		const std::size_t end = std::min(cell + runs[run], size * size);
+		for (; cell < end; cell++) terrain.map[cell / size][cell % size] = run % 2;
+	}
+	return terrain;
+}
+
+std::span<const Chunk::Segment> WorldBake::getSegments(const std::size_t x,
+                                                       const std::size_t y) const {
+	const ChunkEntry& entry = getEntry(x, y);
+	return {reinterpret_cast<const Chunk::Segment*>(file.getData() + entry.segmentsOffset),
+	        entry.segmentCount};
+}
+
+std::span<const Chunk::SpawnCell> WorldBake::getSpawns(const std::size_t x,
+                                                       const std::size_t y) const {
+	const ChunkEntry& entry = getEntry(x, y);
+	return {reinterpret_cast<const Chunk::SpawnCell*>(file.getData() + entry.spawnsOffset),
+	        entry.spawnCount};
+}
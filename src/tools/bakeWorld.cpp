@@ -0,0 +1,71 @@
+// Bakes the chunks around the middle of the CombatScene world to a file, so the game can map
+// them instead of generating them.
+//
+// Usage: bake_world [output] [seed] [radius in chunks] [--rle]
+
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <string>
+
+#include "engine/threadPool.h"
+#include "scenes/combat_scene.h"
+#include "terrain/terrainGenerator.h"
+#include "terrain/worldBake.h"
+
+int main(int argc, char* argv[]) {
+	std::string output = CombatScene::bakePath;
+	std::uint32_t seed = std::random_device{}();
+	std::size_t radius = 8;
+	bool compress = false;
+
+	int positional = 0;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--rle") == 0) {
+			compress = true;
+			continue;
+		}
+		switch (positional++) {
+			case 0:
+				output = argv[i];
+				break;
+			case 1:
+				seed = std::stoul(argv[i]);
+				break;
+			case 2:
+				radius = std::stoul(argv[i]);
+				break;
+			default:
+				std::cerr << "Usage: " << argv[0] << " [output] [seed] [radius] [--rle]\n";
+				return 1;
+		}
+	}
+
+	std::mt19937 randGen{seed};
+	TerrainGenerator gen{randGen};
+	CombatScene::setGeneratorParameters(gen);
+
+	const std::size_t midX = CombatScene::worldChunksX / 2;
+	const std::size_t midY = CombatScene::worldChunksY / 2;
+	const WorldBake::Area area{CombatScene::worldChunksX,
+	                           CombatScene::worldChunksY,
+	                           midX - std::min(radius, midX),
+	                           midY - std::min(radius, midY),
+	                           std::min(2 * radius + 1, CombatScene::worldChunksX),
+	                           std::min(2 * radius + 1, CombatScene::worldChunksY)};
+
+	ThreadPool pool;
+	const auto start = std::chrono::steady_clock::now();
+	if (!WorldBake::bake(output, gen, seed, CombatScene::shapeSize, CombatScene::chunkSize, area,
+	                     compress, pool)) {
+		std::cerr << "Could not write " << output << "\n";
+		return 1;
+	}
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::cout << "Baked " << area.chunksX * area.chunksY << " chunks with seed " << seed
+	          << " to " << output << " in " << elapsed.count() << "s\n";
+	return 0;
+}
@@ -0,0 +1,76 @@
+// Runs the game without a display and times the update and the render of every frame
+// separately, so the cost of the simulation and of drawing can be told apart.
+//
+// Usage: bench_frames [--backend none|software] [--frames count]
+//
+// With the none backend nothing is drawn, which measures the simulation alone. The software
+// backend draws every frame on the CPU.
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "engine/game.h"
+
+namespace {
+// Same size as the window of the game
+constexpr int width = 480 * 3;
+constexpr int height = 280 * 3;
+}  // namespace
+
+int main(int argc, char* argv[]) {
+	RenderBackend::Type backend = RenderBackend::Type::NONE;
+	long frames = 1000;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--backend") == 0 && i + 1 < argc) {
+			const std::string name = argv[++i];
+			if (name == "none" || name == "software") {
+				backend =
+				    name == "none" ? RenderBackend::Type::NONE : RenderBackend::Type::SOFTWARE;
+				continue;
+			}
+		} else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+			frames = std::strtol(argv[++i], nullptr, 10);
+			if (frames > 0) continue;
+		}
+		std::cerr << "Usage: " << argv[0] << " [--backend none|software] [--frames count]\n";
+		return 1;
+	}
+
+	Game game{"bench_frames", width, height, backend};
+	if (!game.running()) return 1;
+	// Same as the game, the none backend has nothing to set it on
+	if (game.getRenderer()) game.setRenderMode(Game::RenderMode::LOW_RESOLUTION);
+	// Frames of the loading scene are not what is measured
+	while (game.isLoadingScene()) std::this_thread::sleep_for(std::chrono::milliseconds{10});
+	game.update();  // Changes to the loaded scene
+
+	using Clock = std::chrono::steady_clock;
+	Clock::duration update{}, render{};
+	for (long i = 0; i < frames && game.running(); i++) {
+		const auto start = Clock::now();
+		game.handleEvents();
+		game.update();
+		const auto updated = Clock::now();
+		game.render();
+		render += Clock::now() - updated;
+		update += updated - start;
+	}
+
+	// The game can quit before all frames are run
+	const RenderBackend::FrameStats& stats = game.getRenderBackend().getStats();
+	if (stats.frames == 0) return 1;
+	auto msPerFrame = [&stats](const Clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count() / stats.frames;
+	};
+	std::cout << stats.frames << " frames\n"
+	          << "  update " << msPerFrame(update) << " ms per frame\n"
+	          << "  render " << msPerFrame(render) << " ms per frame\n"
+	          << "  " << static_cast<double>(stats.commands) / stats.frames
+	          << " RenderManager commands per frame\n";
+	game.clean();
+	return 0;
+}
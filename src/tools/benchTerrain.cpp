@@ -0,0 +1,231 @@
+// Times the stages of the terrain pipeline for several map sizes and seeds. For every map it also
+// records a hash of the generated terrain and the amount of colliders and spawn positions, which
+// have to stay the same when the pipeline is optimized.
+//
+// Usage: bench_terrain [--golden file] > bench_output.txt
+//
+// With --golden the hashes and counts are compared with the file, or written to it if it does
+// not exist yet. Exits with 1 if they differ.
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "engine/game.h"
+#include "engine/scene.h"
+#include "engine/timing.h"
+#include "scenes/combat_scene.h"
+#include "terrain/chunkManager.h"
+#include "terrain/terrainGenerator.h"
+
+namespace {
+class BenchScene : public Scene {
+public:
+	BenchScene(Game& game) : Scene{game} {}
+};
+
+// Sizes are before the edges are added, in cells.
+constexpr std::array<std::size_t, 3> sizes{200, 400, 800};
+constexpr std::array<std::uint32_t, 3> seeds{1, 2, 3};
+// Edits of each kind timed on every map.
+constexpr std::size_t editCount = 10;
+// Same as the crater of a right click in the CombatScene.
+constexpr int craterRange = 5;
+
+using Cell = std::pair<std::size_t, std::size_t>;
+
+bool isRebuilding(const ChunkManager& manager) {
+	for (std::size_t y = 0; y < manager.getChunksY(); y++) {
+		for (std::size_t x = 0; x < manager.getChunksX(); x++) {
+			const Chunk* chunk = manager.getChunk(x, y);
+			if (chunk && chunk->isRebuilding()) return true;
+		}
+	}
+	return false;
+}
+
+/* Filled cells next to an empty cell, where bullets hit, spread over the chunks around the
+ * center. Those are the chunks that are rebuilt when changed.
+ */
+std::vector<Cell> findWallCells(const ChunkManager& manager) {
+	const std::size_t chunkSize = manager.getChunkSize();
+	const std::size_t midX = manager.getChunksX() / 2, midY = manager.getChunksY() / 2;
+	auto filled = [&manager, chunkSize](const std::size_t x, const std::size_t y) {
+		const Chunk* chunk = manager.getChunk(x / chunkSize, y / chunkSize);
+		return chunk && chunk->getTerrain().map[y % chunkSize][x % chunkSize];
+	};
+
+	std::vector<Cell> cells;
+	const std::size_t x1 = (midX - 1) * chunkSize + 1, x2 = (midX + 2) * chunkSize - 1;
+	const std::size_t y1 = (midY - 1) * chunkSize + 1, y2 = (midY + 2) * chunkSize - 1;
+	for (std::size_t y = y1; y < y2; y++) {
+		for (std::size_t x = x1; x < x2; x++) {
+			if (filled(x, y) && (!filled(x - 1, y) || !filled(x + 1, y) || !filled(x, y - 1) ||
+			                     !filled(x, y + 1)))
+				cells.emplace_back(x, y);
+		}
+	}
+
+	// Every editCount'th one, so the edits are spread out
+	std::vector<Cell> spread;
+	const std::size_t step = std::max<std::size_t>(1, cells.size() / editCount);
+	for (std::size_t i = 0; i < cells.size() && spread.size() < editCount; i += step)
+		spread.push_back(cells[i]);
+	return spread;
+}
+
+// @return Average milliseconds from an edit until the rebuilds it started are swapped in.
+template <class Edit>
+double timeEdits(ChunkManager& manager, const std::vector<Cell>& cells, const Edit& edit) {
+	const Vec2 center = manager.getWorldCenter();
+	double total = 0;
+	for (const auto& [x, y] : cells) {
+		const auto start = Timing::Clock::now();
+		edit(x, y);
+		manager.update(0, center);
+		while (isRebuilding(manager)) manager.update(0, center);
+		total += 1000 * Timing::secondsSince(start);
+	}
+	return cells.empty() ? 0 : total / cells.size();
+}
+
+/* Generates and loads one map, and prints how long every stage took.
+ *
+ * @return Line with the hash and counts, which must not change.
+ */
+std::string benchMap(Scene& scene, const std::size_t size, const std::uint32_t seed) {
+	std::mt19937 randGen{seed};
+	TerrainGenerator gen{randGen};
+	CombatScene::setGeneratorParameters(gen);
+	ThreadPool& pool = scene.getGame().getThreadPool();
+
+	TerrainGenerator::StageTimings stages;
+	auto start = Timing::Clock::now();
+	const Terrain terrain = gen.generateTerrain(size, size, CombatScene::shapeSize, seed, pool,
+	                                            &stages);
+	const double generate = 1000 * Timing::secondsSince(start);
+
+	EnemyManager enemyManager{};
+	ChunkManager manager{terrain, CombatScene::chunkSize, 1, SDL_Color{}, scene, enemyManager};
+	const ChunkManager::LoadTimings& load = manager.getLoadTimings();
+
+	// Before the first update, while every chunk still has its colliders
+	std::size_t colliders = 0;
+	for (std::size_t y = 0; y < manager.getChunksY(); y++)
+		for (std::size_t x = 0; x < manager.getChunksX(); x++)
+			colliders += manager.getChunk(x, y)->getColliderCount();
+	start = Timing::Clock::now();
+	manager.updateColliders();
+	const double updateColliders = 1000 * Timing::secondsSince(start);
+
+	std::size_t spawns = 0;
+	start = Timing::Clock::now();
+	for (std::size_t y = 0; y < manager.getChunksY(); y++)
+		for (std::size_t x = 0; x < manager.getChunksX(); x++)
+			spawns += manager.getChunk(x, y)->findSpawnPositions().size();
+	const double findSpawns = 1000 * Timing::secondsSince(start);
+
+	manager.update(0, manager.getWorldCenter());
+	const auto cells = findWallCells(manager);
+	const double bulletHit = timeEdits(manager, cells, [&manager](std::size_t x, std::size_t y) {
+		manager.changeTerrain(x, y, 0);
+	});
+	const float pixelSize = manager.getPixelSize();
+	const double crater = timeEdits(manager, cells, [&](std::size_t x, std::size_t y) {
+		manager.changeTerrainInRange(Vec2{(x + 0.5f) * pixelSize, (y + 0.5f) * pixelSize},
+		                             craterRange, 0);
+	});
+
+	auto ms = [](const double value) {
+		std::ostringstream out;
+		out << std::fixed << std::setprecision(2) << value << " ms";
+		return out.str();
+	};
+	auto msOf = [&ms](const double seconds) { return ms(seconds * 1000); };
+	std::cout << "size " << size << " seed " << seed << " (" << terrain.getXSize() << "x"
+	          << terrain.getYSize() << " cells, " << load.chunks << " chunks)\n"
+	          << "  generate " << ms(generate) << ": shape " << msOf(stages.shape) << ", corners "
+	          << msOf(stages.corners) << ", edges " << msOf(stages.edges) << ", details "
+	          << msOf(stages.details) << "\n"
+	          << "  splitToChunks " << msOf(load.wall) << ": split " << msOf(load.split)
+	          << ", colliders " << msOf(load.build.colliders) << ", spawns "
+	          << msOf(load.build.spawns) << ", render " << msOf(load.build.render)
+	          << " (summed over threads)\n"
+	          << "  updateColliders " << ms(updateColliders) << ", findSpawnPositions "
+	          << ms(findSpawns) << "\n"
+	          << "  edit to rebuild: bullet hit " << ms(bulletHit) << ", crater " << ms(crater)
+	          << " (average of " << cells.size() << ")\n";
+
+	std::ostringstream golden;
+	golden << "size " << size << " seed " << seed << " hash " << std::hex << terrain.getHash()
+	       << std::dec << " colliders " << colliders << " spawns " << spawns;
+	return golden.str();
+}
+
+// @return If the results match the file. Writes them to it instead if it does not exist.
+bool checkGolden(const std::string& path, const std::vector<std::string>& results) {
+	std::ifstream in{path};
+	if (!in) {
+		std::ofstream out{path};
+		for (const std::string& line : results) out << line << "\n";
+		std::cout << "Wrote " << results.size() << " results to " << path << "\n";
+		return static_cast<bool>(out);
+	}
+
+	std::vector<std::string> expected;
+	for (std::string line; std::getline(in, line);)
+		if (!line.empty()) expected.push_back(line);
+
+	bool matches = expected.size() == results.size();
+	for (std::size_t i = 0; i < std::min(expected.size(), results.size()); i++) {
+		if (expected[i] == results[i]) continue;
+		std::cout << "MISMATCH\n  expected " << expected[i] << "\n  found    " << results[i]
+		          << "\n";
+		matches = false;
+	}
+	if (expected.size() != results.size())
+		std::cout << "MISMATCH: expected " << expected.size() << " results, found "
+		          << results.size() << "\n";
+	if (matches) std::cout << "All " << results.size() << " results match " << path << "\n";
+	return matches;
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+	std::string goldenPath;
+	for (int i = 1; i < argc; i++) {
+		if (std::strcmp(argv[i], "--golden") == 0 && i + 1 < argc) {
+			goldenPath = argv[++i];
+			continue;
+		}
+		std::cerr << "Usage: " << argv[0] << " [--golden file]\n";
+		return 1;
+	}
+
+	Game game{"bench_terrain", 0, 0, RenderBackend::Type::NONE};
+	// The game loads its own world on the workers, which would slow down the measurements
+	while (game.isLoadingScene()) std::this_thread::sleep_for(std::chrono::milliseconds{10});
+	BenchScene scene{game};
+
+	std::cout << game.getThreadPool().getThreadCount() << " worker threads\n";
+	std::vector<std::string> results;
+	for (const std::size_t size : sizes)
+		for (const std::uint32_t seed : seeds) results.push_back(benchMap(scene, size, seed));
+
+	std::cout << "\n";
+	for (const std::string& line : results) std::cout << line << "\n";
+	const bool matches = goldenPath.empty() || checkGolden(goldenPath, results);
+	game.clean();
+	return matches ? 0 : 1;
+}
@@ -0,0 +1,212 @@
+// Generates worlds for every combination of the given generator parameters, and reports what
+// each one costs: generation time, collider segments, spawn cells and memory. Runs without a
+// window. Parameters that are not given keep the values of the CombatScene.
+//
+// Usage: sweep_generator [name=value,value,...]... > sweep.csv
+//
+// Example: sweep_generator shapeFillProb=0.15,0.2,0.25 chunkSize=50,100 seed=1,2
+// An invalid argument, like --help, prints the parameter names.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "engine/threadPool.h"
+#include "scenes/combat_scene.h"
+#include "terrain/chunk.h"
+#include "terrain/spawnMap.h"
+#include "terrain/terrainCollider.h"
+#include "terrain/terrainGenerator.h"
+
+namespace {
+// Everything one world is generated from.
+struct Config {
+	TerrainGenerator& gen;
+	std::size_t size = 1000;  // In cells, before the edges are added
+	std::size_t chunkSize = CombatScene::chunkSize;
+	std::size_t shapeSize = CombatScene::shapeSize;
+	std::uint32_t seed = 1;
+};
+
+struct Parameter {
+	const char* name;
+	std::function<void(Config&, double)> set;
+};
+
+const std::vector<Parameter> parameters{
+    {"size", [](Config& c, double v) { c.size = v; }},
+    {"seed", [](Config& c, double v) { c.seed = v; }},
+    {"chunkSize", [](Config& c, double v) { c.chunkSize = v; }},
+    {"shapeSize", [](Config& c, double v) { c.shapeSize = v; }},
+    {"shapeFillProb", [](Config& c, double v) { c.gen.shapeFillProb = v; }},
+    {"shapeGenerations", [](Config& c, double v) { c.gen.shapeGenerations = v; }},
+    {"shapeConsecutiveWallRange",
+     [](Config& c, double v) { c.gen.shapeConsecutiveWallRange = v; }},
+    {"shapeMinConsecutiveWall", [](Config& c, double v) { c.gen.shapeMinConsecutiveWall = v; }},
+    {"shapeWallRandomness", [](Config& c, double v) { c.gen.shapeWallRandomness = v; }},
+    {"shapeCalcCloseRange", [](Config& c, double v) { c.gen.shapeCalcCloseRange = v; }},
+    {"shapeCalcFarRange", [](Config& c, double v) { c.gen.shapeCalcFarRange = v; }},
+    {"shapeCalcMinCloseFill", [](Config& c, double v) { c.gen.shapeCalcMinCloseFill = v; }},
+    {"shapeCalcMaxFarFill", [](Config& c, double v) { c.gen.shapeCalcMaxFarFill = v; }},
+    {"cornerFillProb", [](Config& c, double v) { c.gen.cornerFillProb = v; }},
+    {"cornerGenerations", [](Config& c, double v) { c.gen.cornerGenerations = v; }},
+    {"cornerCalcRange", [](Config& c, double v) { c.gen.cornerCalcRange = v; }},
+    {"cornerCalcMinFill", [](Config& c, double v) { c.gen.cornerCalcMinFill = v; }},
+    {"detailsGenerations", [](Config& c, double v) { c.gen.detailsGenerations = v; }},
+    {"detailsCalcRange", [](Config& c, double v) { c.gen.detailsCalcRange = v; }},
+    {"detailsCalcMinFill", [](Config& c, double v) { c.gen.detailsCalcMinFill = v; }},
+    {"edgeThickness", [](Config& c, double v) { c.gen.edgeThickness = v; }},
+};
+
+// Parameter and the values it is swept over.
+struct Axis {
+	const Parameter* parameter;
+	std::vector<double> values;
+};
+
+const Parameter* findParameter(const std::string& name) {
+	for (const Parameter& parameter : parameters)
+		if (name == parameter.name) return &parameter;
+	return nullptr;
+}
+
+// @return Nothing if arg is not name=value,value,... with a known name.
+std::optional<Axis> parseAxis(const std::string& arg) {
+	const std::size_t equals = arg.find('=');
+	if (equals == std::string::npos) return std::nullopt;
+	const Parameter* parameter = findParameter(arg.substr(0, equals));
+	if (!parameter) return std::nullopt;
+
+	Axis axis{parameter, {}};
+	std::istringstream values{arg.substr(equals + 1)};
+	for (std::string value; std::getline(values, value, ',');) {
+		try {
+			axis.values.push_back(std::stod(value));
+		} catch (...) {
+			return std::nullopt;
+		}
+	}
+	if (axis.values.empty()) return std::nullopt;
+	return axis;
+}
+
+struct Result {
+	double generate = 0;  // Seconds
+	double build = 0;     // Seconds finding the segments and spawn cells, summed over threads
+	std::size_t chunks = 0;
+	std::size_t segments = 0;
+	std::size_t spawnCells = 0;
+	std::size_t residentBytes = 0;
+};
+
+// Generates a world and builds what the chunks keep when they are active.
+Result measure(const Config& config, ThreadPool& pool) {
+	Result result;
+	const auto start = std::chrono::steady_clock::now();
+	const Terrain terrain =
+	    config.gen.generateTerrain(config.size, config.size, config.shapeSize, config.seed, pool);
+	result.generate =
+	    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	const std::size_t chunksX = terrain.getXSize() / config.chunkSize;
+	const std::size_t chunksY = terrain.getYSize() / config.chunkSize;
+	result.chunks = chunksX * chunksY;
+	std::atomic<std::size_t> segments{0}, spawnCells{0};
+	std::vector<double> build(result.chunks);
+	pool.parallelFor(result.chunks, [&](const std::size_t i) {
+		const std::size_t x = i % chunksX, y = i / chunksX;
+		Terrain chunk{config.chunkSize, config.chunkSize};
+		for (std::size_t row = 0; row < config.chunkSize; row++) {
+			const auto& source = terrain.map[y * config.chunkSize + row];
+			const auto begin = source.begin() + x * config.chunkSize;
+			std::copy(begin, begin + config.chunkSize, chunk.map[row].begin());
+		}
+
+		const auto start = std::chrono::steady_clock::now();
+		segments += Chunk::findSegments(chunk).size();
+		spawnCells += SpawnMap{chunk}.getCount();
+		build[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	});
+	for (const double seconds : build) result.build += seconds;
+	result.segments = segments;
+	result.spawnCells = spawnCells;
+
+	// Terrain, the reach and bits of the spawn maps, and the colliders
+	const std::size_t cells = result.chunks * config.chunkSize * config.chunkSize;
+	result.residentBytes = cells * (1 + sizeof(std::uint16_t)) + cells / 8 +
+	                       result.segments * sizeof(TerrainCollider);
+	return result;
+}
+
+// @return Why config can not be generated, or nothing if it can.
+std::optional<std::string> checkConfig(const Config& config) {
+	if (config.shapeSize == 0 || config.size % config.shapeSize != 0)
+		return "shapeSize must divide size";
+	const std::size_t total = config.size + 2 * config.gen.edgeThickness;
+	if (config.chunkSize == 0 || total % config.chunkSize != 0)
+		return "chunkSize must divide size + 2 * edgeThickness";
+	return std::nullopt;
+}
+
+void printUsage(const char* program) {
+	std::cerr << "Usage: " << program << " [name=value,value,...]...\nParameters:";
+	for (const Parameter& parameter : parameters) std::cerr << " " << parameter.name;
+	std::cerr << "\n";
+}
+}  // namespace
+
+int main(int argc, char* argv[]) {
+	std::vector<Axis> axes;
+	for (int i = 1; i < argc; i++) {
+		const std::optional<Axis> axis = parseAxis(argv[i]);
+		if (!axis) {
+			std::cerr << "Invalid argument " << argv[i] << "\n";
+			printUsage(argv[0]);
+			return 1;
+		}
+		axes.push_back(*axis);
+	}
+
+	std::cout << "config";
+	for (const Axis& axis : axes) std::cout << "," << axis.parameter->name;
+	std::cout << ",generate_ms,build_ms,chunks,segments,segments_per_chunk,spawn_cells,"
+	             "resident_kb\n";
+
+	ThreadPool pool;
+	std::mt19937 randGen;
+	// Every combination of the values, the first axis changes the slowest
+	std::vector<std::size_t> index(axes.size(), 0);
+	for (std::size_t config = 0;; config++) {
+		TerrainGenerator gen{randGen};
+		CombatScene::setGeneratorParameters(gen);
+		Config current{gen};
+		for (std::size_t i = 0; i < axes.size(); i++)
+			axes[i].parameter->set(current, axes[i].values[index[i]]);
+
+		std::cout << config;
+		for (std::size_t i = 0; i < axes.size(); i++) std::cout << "," << axes[i].values[index[i]];
+		if (const std::optional<std::string> error = checkConfig(current)) {
+			std::cout << ",skipped: " << *error << "\n";
+		} else {
+			const Result result = measure(current, pool);
+			std::cout << "," << result.generate * 1000 << "," << result.build * 1000 << ","
+			          << result.chunks << "," << result.segments << ","
+			          << static_cast<double>(result.segments) / result.chunks << ","
+			          << result.spawnCells << "," << result.residentBytes / 1024 << "\n";
+		}
+
+		// Next combination
+		std::size_t i = axes.size();
+		while (i > 0 && ++index[i - 1] == axes[i - 1].values.size()) index[--i] = 0;
+		if (i == 0) break;
+	}
+	return 0;
+}
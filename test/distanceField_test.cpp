@@ -0,0 +1,105 @@
+#include "terrain/distanceField.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <limits>
+#include <random>
+
+namespace {
+constexpr std::size_t xSize = 60;
+constexpr std::size_t ySize = 50;
+
+Terrain randomTerrain(std::mt19937& randGen) {
+	std::bernoulli_distribution filled{0.01};
+	Terrain terrain{xSize, ySize};
+	for (auto& row : terrain.map)
+		for (unsigned char& cell : row) cell = filled(randGen);
+	return terrain;
+}
+
+// Cells outside the terrain are empty
+DistanceField::CellReader readerOf(const Terrain& terrain) {
+	return [&terrain](CellGrid& window, std::ptrdiff_t x, std::ptrdiff_t y) {
+		for (std::size_t wy = 0; wy < window.ySize; wy++) {
+			for (std::size_t wx = 0; wx < window.xSize; wx++) {
+				const std::ptrdiff_t cellX = x + wx, cellY = y + wy;
+				const bool inside = cellX >= 0 && cellY >= 0 && cellX < static_cast<int>(xSize) &&
+				                    cellY < static_cast<int>(ySize);
+				window.at(wx, wy) = inside ? terrain.map[cellY][cellX] : 0;
+			}
+		}
+	};
+}
+
+// With a one cell border around the terrain, like the chunk fields
+DistanceField makeField() { return DistanceField{-1, -1, xSize + 2, ySize + 2}; }
+
+float bruteForce(const Terrain& terrain, const std::ptrdiff_t x, const std::ptrdiff_t y) {
+	float closest = std::numeric_limits<float>::max();
+	for (std::size_t cellY = 0; cellY < ySize; cellY++) {
+		for (std::size_t cellX = 0; cellX < xSize; cellX++) {
+			if (!terrain.map[cellY][cellX]) continue;
+			const float dx = x - static_cast<std::ptrdiff_t>(cellX);
+			const float dy = y - static_cast<std::ptrdiff_t>(cellY);
+			closest = std::min(closest, std::hypot(dx, dy));
+		}
+	}
+	return std::min(closest, static_cast<float>(DistanceField::maxDistance));
+}
+
+void expectMatches(const DistanceField& field, const Terrain& terrain) {
+	for (std::ptrdiff_t y = -1; y <= static_cast<int>(ySize); y++)
+		for (std::ptrdiff_t x = -1; x <= static_cast<int>(xSize); x++)
+			ASSERT_FLOAT_EQ(field.getDistance(x, y), bruteForce(terrain, x, y)) << x << ", " << y;
+}
+}  // namespace
+
+TEST(DistanceField, MatchesBruteForce) {
+	std::mt19937 randGen{2};
+	for (int i = 0; i < 3; i++) {
+		const Terrain terrain = randomTerrain(randGen);
+		DistanceField field = makeField();
+		field.update(readerOf(terrain));
+		expectMatches(field, terrain);
+	}
+}
+
+TEST(DistanceField, UpdatesAroundEdits) {
+	std::mt19937 randGen{8};
+	Terrain terrain = randomTerrain(randGen);
+	DistanceField field = makeField();
+	field.update(readerOf(terrain));
+
+	std::uniform_int_distribution<std::size_t> xDist{0, xSize - 3}, yDist{0, ySize - 3};
+	for (int i = 0; i < 30; i++) {
+		const std::size_t x = xDist(randGen), y = yDist(randGen);
+		const unsigned char value = i % 2;
+		for (std::size_t cellY = y; cellY < y + 3; cellY++)
+			for (std::size_t cellX = x; cellX < x + 3; cellX++) terrain.map[cellY][cellX] = value;
+
+		constexpr int reach = DistanceField::maxDistance;
+		field.update(readerOf(terrain), x - reach, y - reach, x + 2 + reach, y + 2 + reach);
+		expectMatches(field, terrain);
+	}
+}
+
+TEST(DistanceField, PointsAwayFromTerrain) {
+	Terrain terrain{xSize, ySize};
+	terrain.map[20][30] = 1;
+	DistanceField field = makeField();
+	field.update(readerOf(terrain));
+
+	// Right of and below the filled cell
+	const DistanceField::Sample right = field.sample(35, 20, Vec2{0.5f, 0.5f});
+	EXPECT_FLOAT_EQ(right.distance, 5);
+	EXPECT_GT(right.direction.x, 0.9f);
+	const DistanceField::Sample below = field.sample(30, 24, Vec2{0.5f, 0.5f});
+	EXPECT_FLOAT_EQ(below.distance, 4);
+	EXPECT_GT(below.direction.y, 0.9f);
+
+	// Far away everything is at the cap
+	const DistanceField::Sample far = field.sample(5, 5, Vec2{0.5f, 0.5f});
+	EXPECT_FLOAT_EQ(far.distance, DistanceField::maxDistance);
+	EXPECT_FLOAT_EQ(far.direction.magnitude(), 0);
+}
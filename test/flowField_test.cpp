@@ -0,0 +1,112 @@
+#include "terrain/flowField.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <queue>
+#include <random>
+
+namespace {
+constexpr std::size_t xSize = 40;
+constexpr std::size_t ySize = 30;
+
+// Far from all terrain, so there are no extra costs
+std::vector<float> noWalls() { return std::vector<float>(xSize * ySize, FlowField::avoidDistance); }
+
+/* Follows the directions from world cell (x, y).
+ * @param originX, originY World cell of the first cell in cells.
+ * @return If the target was reached.
+ */
+bool follow(const FlowField& field, const CellGrid& cells, std::size_t x, std::size_t y,
+            const std::size_t originX = 0, const std::size_t originY = 0) {
+	for (std::size_t steps = 0; steps < xSize * ySize; steps++) {
+		if (x == field.getTargetX() && y == field.getTargetY()) return true;
+		const auto direction = field.getDirection(x, y);
+		if (!direction) return false;
+		x += std::lround(direction->x / std::abs(direction->x == 0 ? 1 : direction->x));
+		y += std::lround(direction->y / std::abs(direction->y == 0 ? 1 : direction->y));
+		EXPECT_EQ(cells.at(x - originX, y - originY), 0) << "Stepped into terrain at " << x << ", "
+		                                                 << y;
+	}
+	return false;
+}
+}  // namespace
+
+TEST(FlowField, MatchesDijkstra) {
+	std::mt19937 randGen{4};
+	std::bernoulli_distribution filled{0.25};
+	CellGrid cells{xSize, ySize};
+	for (unsigned char& cell : cells.cells) cell = filled(randGen);
+	cells.at(20, 15) = 0;
+	const FlowField field{cells, noWalls(), 0, 0, 20, 15};
+
+	// Plain Dijkstra with a priority queue and the same steps
+	std::vector<std::uint32_t> costs(xSize * ySize, UINT32_MAX);
+	using Entry = std::pair<std::uint32_t, std::size_t>;
+	std::priority_queue<Entry, std::vector<Entry>, std::greater<>> queue;
+	costs[15 * xSize + 20] = 0;
+	queue.emplace(0, 15 * xSize + 20);
+	while (!queue.empty()) {
+		const auto [cost, index] = queue.top();
+		queue.pop();
+		if (cost != costs[index]) continue;
+		const int x = index % xSize, y = index / xSize;
+		for (int dy = -1; dy <= 1; dy++) {
+			for (int dx = -1; dx <= 1; dx++) {
+				const int nextX = x + dx, nextY = y + dy;
+				if ((dx == 0 && dy == 0) || nextX < 0 || nextY < 0 || nextX >= (int)xSize ||
+				    nextY >= (int)ySize || cells.at(nextX, nextY))
+					continue;
+				if (dx != 0 && dy != 0 && (cells.at(nextX, y) || cells.at(x, nextY))) continue;
+
+				const std::uint32_t next = cost + (dx != 0 && dy != 0 ? FlowField::diagonalCost
+				                                                      : FlowField::straightCost);
+				if (next >= costs[nextY * xSize + nextX]) continue;
+				costs[nextY * xSize + nextX] = next;
+				queue.emplace(next, nextY * xSize + nextX);
+			}
+		}
+	}
+
+	for (std::size_t y = 0; y < ySize; y++) {
+		for (std::size_t x = 0; x < xSize; x++) {
+			const auto cost = field.getCost(x, y);
+			ASSERT_EQ(cost.value_or(UINT32_MAX), costs[y * xSize + x]) << x << ", " << y;
+			if (cost && *cost != 0) EXPECT_TRUE(follow(field, cells, x, y));
+		}
+	}
+}
+
+TEST(FlowField, LeadsThroughGap) {
+	// Wall across the middle with one gap, and a closed box the target can not be reached from
+	CellGrid cells{xSize, ySize};
+	for (std::size_t y = 0; y < ySize; y++)
+		if (y != 25) cells.at(20, y) = 1;
+	for (std::size_t i = 0; i < 5; i++) {
+		cells.at(2 + i, 2) = cells.at(2 + i, 6) = 1;
+		cells.at(2, 2 + i) = cells.at(6, 2 + i) = 1;
+	}
+	const FlowField field{cells, noWalls(), 10, 5, 35, 8};
+
+	// In world cells, the area starts at (10, 5)
+	EXPECT_TRUE(follow(field, cells, 12 + 10, 18 + 5, 10, 5));
+	EXPECT_GT(*field.getCost(11 + 10, 8 + 5), *field.getCost(19 + 10, 8 + 5));
+	EXPECT_FALSE(field.getCost(4 + 10, 4 + 5).has_value());
+	EXPECT_FALSE(field.getDirection(14, 9).has_value());
+	EXPECT_FALSE(field.getDirection(5, 5).has_value());  // Outside
+	EXPECT_FALSE(FlowField{}.getDirection(0, 0).has_value());
+}
+
+TEST(FlowField, KeepsAwayFromWalls) {
+	// Open area, but everything above the middle row is close to a wall
+	CellGrid cells{xSize, ySize};
+	std::vector<float> wallDistance(xSize * ySize, FlowField::avoidDistance);
+	for (std::size_t y = 0; y < ySize / 2; y++)
+		for (std::size_t x = 0; x < xSize; x++) wallDistance[y * xSize + x] = 1;
+	const FlowField field{cells, wallDistance, 0, 0, 35, 20};
+
+	// Moves down out of the expensive area first instead of going straight at the target
+	const auto direction = field.getDirection(5, 13);
+	ASSERT_TRUE(direction.has_value());
+	EXPECT_GT(direction->y, 0.5f);
+}
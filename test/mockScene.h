@@ -6,6 +6,8 @@ class MockScene : public Scene {
 public:
 	MockScene(Game& game) : Scene{game} {}
 
+	using Scene::updateCollision;
+
 	int objCount() const { return getGameObjects().size(); }
 	int delCount() const {
 		int res = 0;
@@ -0,0 +1,95 @@
+#include "terrain/regionLabels.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+#include <vector>
+
+namespace {
+constexpr std::size_t xSize = 40;
+constexpr std::size_t ySize = 30;
+
+Terrain randomTerrain(std::mt19937& randGen, const double fill) {
+	std::bernoulli_distribution filled{fill};
+	Terrain terrain{xSize, ySize};
+	for (auto& row : terrain.map)
+		for (unsigned char& cell : row) cell = filled(randGen);
+	return terrain;
+}
+
+// Flood fills the empty cells, @return Region number of every cell, 0 for filled ones.
+std::vector<int> floodFill(const Terrain& terrain) {
+	std::vector<int> result(xSize * ySize, 0);
+	int regions = 0;
+	for (std::size_t startY = 0; startY < ySize; startY++) {
+		for (std::size_t startX = 0; startX < xSize; startX++) {
+			if (terrain.map[startY][startX] || result[startY * xSize + startX]) continue;
+
+			regions++;
+			std::vector<std::pair<std::size_t, std::size_t>> stack{{startX, startY}};
+			result[startY * xSize + startX] = regions;
+			while (!stack.empty()) {
+				const auto [x, y] = stack.back();
+				stack.pop_back();
+				const std::pair<std::size_t, std::size_t> neighbours[]{
+				    {x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+				for (const auto [nextX, nextY] : neighbours) {
+					if (nextX >= xSize || nextY >= ySize || terrain.map[nextY][nextX]) continue;
+					int& region = result[nextY * xSize + nextX];
+					if (region) continue;
+					region = regions;
+					stack.emplace_back(nextX, nextY);
+				}
+			}
+		}
+	}
+	return result;
+}
+
+// The regions have to be the same partition of the cells, the numbers do not matter
+void expectSameRegions(const RegionLabels& labels, const Terrain& terrain) {
+	const std::vector<int> expected = floodFill(terrain);
+	std::map<int, std::uint32_t> toLabel;
+	std::map<std::uint32_t, int> toExpected;
+	for (std::size_t y = 0; y < ySize; y++) {
+		for (std::size_t x = 0; x < xSize; x++) {
+			const std::uint32_t region = labels.getRegion(x, y);
+			const int expectedRegion = expected[y * xSize + x];
+			ASSERT_EQ(region == RegionLabels::noRegion, expectedRegion == 0) << x << ", " << y;
+			if (expectedRegion == 0) continue;
+
+			ASSERT_EQ(toLabel.emplace(expectedRegion, region).first->second, region);
+			ASSERT_EQ(toExpected.emplace(region, expectedRegion).first->second, expectedRegion);
+		}
+	}
+}
+}  // namespace
+
+TEST(RegionLabels, MatchesFloodFill) {
+	std::mt19937 randGen{6};
+	for (const double fill : {0.1, 0.4, 0.6}) {
+		const Terrain terrain = randomTerrain(randGen, fill);
+		expectSameRegions(RegionLabels{terrain}, terrain);
+	}
+}
+
+TEST(RegionLabels, OpeningJoinsRegions) {
+	std::mt19937 randGen{12};
+	Terrain terrain = randomTerrain(randGen, 0.6);
+	RegionLabels labels{terrain};
+
+	// Enough openings that the labels are started over at some point
+	std::uniform_int_distribution<std::size_t> xDist{0, xSize - 1}, yDist{0, ySize - 1};
+	for (int i = 0; i < 300; i++) {
+		std::vector<std::pair<std::size_t, std::size_t>> opened;
+		for (int j = 0; j < 5; j++) {
+			const std::size_t x = xDist(randGen), y = yDist(randGen);
+			if (!terrain.map[y][x]) continue;
+			terrain.map[y][x] = 0;
+			opened.emplace_back(x, y);
+		}
+		labels.open(terrain, opened);
+		expectSameRegions(labels, terrain);
+	}
+}
@@ -0,0 +1,56 @@
+#include "engine/renderManager.h"
+
+#include <gtest/gtest.h>
+
+#include <array>
+
+#include "engine/UI/widget.h"
+#include "engine/gameObject.h"
+
+namespace {
+constexpr SDL_Color white{255, 255, 255, 255};
+constexpr SDL_Rect rect{0, 0, 16, 16};
+}  // namespace
+
+TEST(RenderManager, SortsByLayerKeepingOrder) {
+	// Never dereferenced, only compared
+	std::array<char, 2> textureMemory;
+	SDL_Texture* textureA = reinterpret_cast<SDL_Texture*>(&textureMemory[0]);
+	SDL_Texture* textureB = reinterpret_cast<SDL_Texture*>(&textureMemory[1]);
+
+	RenderManager manager;
+	manager.addSprite(textureB, rect, rect, 0, SDL_Point{}, SDL_FLIP_NONE, 0);
+	manager.addLine(SDL_FPoint{0, 0}, SDL_FPoint{1, 1}, white, 1);
+	manager.addSprite(textureA, rect, rect, 0, SDL_Point{}, SDL_FLIP_NONE, 0);
+	manager.addFillRect(SDL_FRect{0, 0, 1, 1}, white, 0);
+	manager.addSprite(textureB, rect, SDL_Rect{1, 0, 16, 16}, 0, SDL_Point{}, SDL_FLIP_NONE, 0);
+	manager.update();
+
+	const auto& commands = manager.getCommands();
+	ASSERT_EQ(commands.size(), 5);
+	// Later commands on a layer are drawn on top, whatever their texture
+	EXPECT_EQ(commands[0].texture, textureB);
+	EXPECT_EQ(commands[1].texture, textureA);
+	EXPECT_EQ(commands[2].type, RenderCommand::Type::FILL_RECT);
+	EXPECT_EQ(commands[3].texture, textureB);
+	EXPECT_EQ(commands[3].sprite.dest.x, 1);
+	EXPECT_EQ(commands[4].type, RenderCommand::Type::LINE);
+}
+
+TEST(RenderManager, DropsWidgetsOfDeletedParents) {
+	UI::Widget widget;
+	GameObject kept, deleted;
+	deleted.deleteObject = true;
+
+	RenderManager manager;
+	manager.addWidget(widget, &deleted, RenderManager::uiLayer);
+	manager.addWidget(widget, &kept, RenderManager::uiLayer);
+	manager.addLine(SDL_FPoint{0, 0}, SDL_FPoint{1, 1}, white, RenderManager::debugLayer);
+	manager.update();
+	ASSERT_EQ(manager.getCommands().size(), 2);
+	EXPECT_EQ(manager.getCommands()[1].widget.parent, &kept);
+
+	// The next frame starts empty
+	manager.clear();
+	EXPECT_TRUE(manager.getCommands().empty());
+}
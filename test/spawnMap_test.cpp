@@ -0,0 +1,91 @@
+#include "terrain/spawnMap.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdlib>
+#include <random>
+
+namespace {
+constexpr std::size_t xSize = 90;
+constexpr std::size_t ySize = 70;
+
+// Mostly empty, so that there are places to spawn
+Terrain randomTerrain(std::mt19937& randGen) {
+	std::bernoulli_distribution filled{0.002};
+	Terrain terrain{xSize, ySize};
+	for (auto& row : terrain.map)
+		for (unsigned char& cell : row) cell = filled(randGen);
+	return terrain;
+}
+
+// Checks every cell of the spawn circle directly
+bool circleFits(const Terrain& terrain, const std::size_t x, const std::size_t y) {
+	constexpr int space = SpawnMap::minSpace;
+	if (x < space || y < space || x + space >= xSize || y + space >= ySize) return false;
+
+	for (int dx = -(space - 1); dx < space; dx++) {
+		const int height = SpawnMap::circleY[std::abs(dx)];
+		for (int dy = -height; dy <= height; dy++)
+			if (terrain.map[y + dy][x + dx]) return false;
+	}
+	return true;
+}
+
+void expectMatches(const SpawnMap& map, const Terrain& terrain) {
+	std::size_t count = 0;
+	for (std::size_t y = 0; y < ySize; y++) {
+		for (std::size_t x = 0; x < xSize; x++) {
+			ASSERT_EQ(map.isSpawnable(x, y), circleFits(terrain, x, y)) << x << ", " << y;
+			count += circleFits(terrain, x, y);
+		}
+	}
+	EXPECT_EQ(map.getCount(), count);
+}
+}  // namespace
+
+TEST(SpawnMap, MatchesCircleCheck) {
+	std::mt19937 randGen{3};
+	for (int i = 0; i < 5; i++) {
+		const Terrain terrain = randomTerrain(randGen);
+		const SpawnMap map{terrain};
+		expectMatches(map, terrain);
+		EXPECT_GT(map.getCount(), 0);
+	}
+}
+
+TEST(SpawnMap, UpdatesAroundEdits) {
+	std::mt19937 randGen{11};
+	Terrain terrain = randomTerrain(randGen);
+	SpawnMap map{terrain};
+
+	std::uniform_int_distribution<std::size_t> xDist{0, xSize - 4}, yDist{0, ySize - 4};
+	std::uniform_int_distribution<std::size_t> sizeDist{0, 3};
+	for (int i = 0; i < 50; i++) {
+		// Small rectangles, both filling and clearing
+		const std::size_t x1 = xDist(randGen), y1 = yDist(randGen);
+		const std::size_t x2 = x1 + sizeDist(randGen), y2 = y1 + sizeDist(randGen);
+		const unsigned char value = i % 3 == 0 ? 0 : 1;
+		for (std::size_t y = y1; y <= y2; y++)
+			for (std::size_t x = x1; x <= x2; x++) terrain.map[y][x] = value;
+
+		map.update(terrain, x1, x2);
+		expectMatches(map, terrain);
+	}
+}
+
+TEST(SpawnMap, SamplesSpawnableCells) {
+	std::mt19937 randGen{5};
+	const Terrain terrain = randomTerrain(randGen);
+	const SpawnMap map{terrain};
+
+	for (int i = 0; i < 200; i++) {
+		const auto cell = map.sample(randGen);
+		ASSERT_TRUE(cell.has_value());
+		EXPECT_TRUE(map.isSpawnable(cell->first, cell->second));
+	}
+
+	EXPECT_FALSE(SpawnMap{}.sample(randGen).has_value());
+	Terrain full{xSize, ySize};
+	for (auto& row : full.map) std::fill(row.begin(), row.end(), 1);
+	EXPECT_FALSE(SpawnMap{full}.sample(randGen).has_value());
+}
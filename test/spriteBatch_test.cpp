@@ -0,0 +1,61 @@
+#include "engine/spriteBatch.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+constexpr SDL_Color white{255, 255, 255, 255};
+
+void expectPosition(const SDL_Vertex& vertex, const float x, const float y) {
+	EXPECT_NEAR(vertex.position.x, x, 1e-4f);
+	EXPECT_NEAR(vertex.position.y, y, 1e-4f);
+}
+
+void expectTexCoord(const SDL_Vertex& vertex, const float u, const float v) {
+	EXPECT_FLOAT_EQ(vertex.tex_coord.x, u);
+	EXPECT_FLOAT_EQ(vertex.tex_coord.y, v);
+}
+}  // namespace
+
+TEST(SpriteBatch, UnrotatedQuadCoversDestination) {
+	const auto quad = SpriteBatch::makeQuad(64, 32, SDL_Rect{32, 0, 32, 32},
+	                                        SDL_Rect{10, 20, 96, 96}, 0, SDL_Point{48, 48},
+	                                        SDL_FLIP_NONE, white);
+	expectPosition(quad[0], 10, 20);
+	expectPosition(quad[1], 106, 20);
+	expectPosition(quad[2], 106, 116);
+	expectPosition(quad[3], 10, 116);
+
+	// The right half of the texture
+	expectTexCoord(quad[0], 0.5f, 0);
+	expectTexCoord(quad[2], 1, 1);
+	EXPECT_EQ(quad[0].color.a, 255);
+}
+
+TEST(SpriteBatch, RotatesClockwiseAroundPivot) {
+	// Pivot at the top left corner, a quarter turn moves the top right corner straight down
+	const auto quad =
+	    SpriteBatch::makeQuad(32, 32, SDL_Rect{0, 0, 32, 32}, SDL_Rect{100, 100, 40, 20}, 90,
+	                          SDL_Point{0, 0}, SDL_FLIP_NONE, white);
+	expectPosition(quad[0], 100, 100);
+	expectPosition(quad[1], 100, 140);
+	expectPosition(quad[2], 80, 140);
+	expectPosition(quad[3], 80, 100);
+}
+
+TEST(SpriteBatch, FlipSwapsTextureCoordinates) {
+	const SDL_Rect src{0, 0, 16, 16};
+	const SDL_Rect dest{0, 0, 48, 48};
+	const auto horizontal = SpriteBatch::makeQuad(16, 16, src, dest, 0, SDL_Point{24, 24},
+	                                              SDL_FLIP_HORIZONTAL, white);
+	expectTexCoord(horizontal[0], 1, 0);
+	expectTexCoord(horizontal[2], 0, 1);
+
+	const auto vertical = SpriteBatch::makeQuad(16, 16, src, dest, 0, SDL_Point{24, 24},
+	                                            SDL_FLIP_VERTICAL, white);
+	expectTexCoord(vertical[0], 0, 1);
+	expectTexCoord(vertical[2], 1, 0);
+
+	// Flipping does not move the corners
+	expectPosition(horizontal[1], 48, 0);
+	expectPosition(vertical[1], 48, 0);
+}
@@ -0,0 +1,99 @@
+#include "terrain/terrainGenerator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "engine/threadPool.h"
+
+namespace {
+// Same parameters as the CombatScene, with thinner edges to keep the tests fast
+void setParameters(TerrainGenerator& gen) {
+	gen.shapeFillProb = 0.2;
+	gen.shapeGenerations = 5;
+	gen.shapeCalcCloseRange = 1;
+	gen.shapeCalcFarRange = 4;
+	gen.shapeCalcMinCloseFill = 5;
+	gen.shapeCalcMaxFarFill = 15;
+	gen.shapeWallRandomness = 0.3;
+	gen.shapeConsecutiveWallRange = 2;
+	gen.shapeMinConsecutiveWall = 2;
+
+	gen.cornerFillProb = 0.3;
+	gen.cornerGenerations = 3;
+	gen.cornerCalcRange = 1;
+	gen.cornerCalcMinFill = 4;
+
+	gen.detailsGenerations = 1;
+	gen.detailsCalcRange = 2;
+	gen.detailsCalcMinFill = 8;
+
+	gen.edgeThickness = 20;
+}
+}  // namespace
+
+TEST(TerrainGenerator, ParallelSize) {
+	std::mt19937 randGen;
+	TerrainGenerator gen{randGen};
+	setParameters(gen);
+	ThreadPool pool{2};
+
+	const Terrain terrain = gen.generateTerrain(200, 100, 10, 1, pool);
+	EXPECT_EQ(terrain.getXSize(), 200 + 2 * gen.edgeThickness);
+	EXPECT_EQ(terrain.getYSize(), 100 + 2 * gen.edgeThickness);
+}
+
+TEST(TerrainGenerator, ParallelDeterministicAcrossThreadCounts) {
+	std::mt19937 randGen;
+	TerrainGenerator gen{randGen};
+	setParameters(gen);
+
+	ThreadPool single{1};
+	const Terrain expected = gen.generateTerrain(300, 200, 10, 1234, single);
+
+	for (const std::size_t threads : {2, 3, 8}) {
+		ThreadPool pool{threads};
+		const Terrain result = gen.generateTerrain(300, 200, 10, 1234, pool);
+		EXPECT_TRUE(result.map == expected.map)
+		    << "Different terrain with " << threads << " threads";
+		EXPECT_EQ(result.getHash(), expected.getHash());
+	}
+}
+
+TEST(TerrainGenerator, ParallelSeedChangesTerrain) {
+	std::mt19937 randGen;
+	TerrainGenerator gen{randGen};
+	setParameters(gen);
+	ThreadPool pool{2};
+
+	const Terrain a = gen.generateTerrain(200, 200, 10, 1, pool);
+	const Terrain b = gen.generateTerrain(200, 200, 10, 2, pool);
+	EXPECT_FALSE(a.map == b.map);
+	EXPECT_NE(a.getHash(), b.getHash());
+}
+
+TEST(TerrainGenerator, RegionsLineUp) {
+	std::mt19937 randGen;
+	TerrainGenerator gen{randGen};
+	setParameters(gen);
+	ThreadPool pool{2};
+
+	// Generated separately, the halves must match the same area generated in one go
+	const CellGrid whole = gen.generateRegion(350, 20, 200, 100, 10, 7, pool);
+	const CellGrid left = gen.generateRegion(350, 20, 100, 100, 10, 7, pool);
+	const CellGrid right = gen.generateRegion(450, 20, 100, 100, 10, 7, pool);
+	// Touches the start of the world, where the apron is clamped
+	const CellGrid corner = gen.generateRegion(0, 0, 100, 100, 10, 7, pool);
+	const CellGrid cornerWhole = gen.generateRegion(0, 0, 250, 150, 10, 7, pool);
+
+	const auto filled = std::count(whole.cells.begin(), whole.cells.end(), 1);
+	ASSERT_TRUE(filled > 0 && filled < whole.cells.size()) << "Region has no variation";
+
+	for (std::size_t y = 0; y < 100; y++) {
+		for (std::size_t x = 0; x < 100; x++) {
+			ASSERT_EQ(left.at(x, y), whole.at(x, y)) << "(" << x << ", " << y << ")";
+			ASSERT_EQ(right.at(x, y), whole.at(x + 100, y)) << "(" << x << ", " << y << ")";
+			ASSERT_EQ(corner.at(x, y), cornerWhole.at(x, y)) << "(" << x << ", " << y << ")";
+		}
+	}
+}
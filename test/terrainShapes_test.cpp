@@ -0,0 +1,112 @@
+#include "terrain/terrainShapes.h"
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+
+namespace {
+constexpr std::size_t xSize = 100;
+constexpr std::size_t ySize = 80;
+
+using Grid = std::vector<std::vector<unsigned char>>;
+
+void applySpans(Grid& grid, const std::vector<TerrainSpan>& spans) {
+	for (const TerrainSpan& span : spans) {
+		ASSERT_LT(span.x1, span.x2);
+		ASSERT_LE(span.x2, xSize);
+		ASSERT_LT(span.y, ySize);
+		for (std::size_t x = span.x1; x < span.x2; x++) grid[span.y][x] = span.value;
+	}
+}
+
+// The circle as changeTerrainInRange used to find it, one column at a time
+Grid oldCircle(const int centerX, const int centerY, int range) {
+	Grid grid(ySize, std::vector<unsigned char>(xSize));
+	++range;
+	std::vector<int> maxY(range);
+	for (int x = 0; x < range; ++x)
+		maxY[x] = std::round(std::sin(std::acos((float)x / range)) * range);
+	for (int x = -range + 1; x < range; ++x) {
+		if (centerX + x < 0 || centerX + x >= static_cast<int>(xSize)) continue;
+		for (int y = -maxY[std::abs(x)] + 1; y < maxY[std::abs(x)]; ++y) {
+			if (centerY + y < 0 || centerY + y >= static_cast<int>(ySize)) continue;
+			grid[centerY + y][centerX + x] = 1;
+		}
+	}
+	return grid;
+}
+}  // namespace
+
+static_assert(TerrainShapes::roundedSqrt(0) == 0 && TerrainShapes::roundedSqrt(2) == 1 &&
+              TerrainShapes::roundedSqrt(3) == 2 && TerrainShapes::roundedSqrt(100) == 10);
+static_assert(TerrainShapes::circleStencils[5][0] == 5 &&
+              TerrainShapes::circleStencils[0][0] == 0);
+
+TEST(TerrainShapes, CircleMatchesOldCircle) {
+	// Also past the stencils, and clipped at every side
+	for (const int radius : {0, 1, 2, 5, 17, 40, 64, 65, 90}) {
+		for (const auto [x, y] : {std::pair{50, 40}, std::pair{3, 4}, std::pair{98, 77}}) {
+			std::vector<TerrainSpan> spans;
+			TerrainShapes::circle(x, y, radius, 1, xSize, ySize, spans);
+			Grid grid(ySize, std::vector<unsigned char>(xSize));
+			applySpans(grid, spans);
+			EXPECT_EQ(grid, oldCircle(x, y, radius)) << "Radius " << radius << " at " << x;
+		}
+	}
+}
+
+TEST(TerrainShapes, CapsuleCoversLine) {
+	constexpr int radius = 6;
+	std::vector<TerrainSpan> spans;
+	TerrainShapes::capsule(10, 60, 85, 15, radius, 1, xSize, ySize, spans);
+	Grid grid(ySize, std::vector<unsigned char>(xSize));
+	applySpans(grid, spans);
+
+	// Both ends are full circles, and nothing far from the line is touched
+	for (const auto [x, y] : {std::pair{10, 60}, std::pair{85, 15}}) {
+		const Grid end = oldCircle(x, y, radius);
+		for (std::size_t cellY = 0; cellY < ySize; cellY++)
+			for (std::size_t cellX = 0; cellX < xSize; cellX++)
+				if (end[cellY][cellX]) EXPECT_EQ(grid[cellY][cellX], 1);
+	}
+	const float lengthX = 75, lengthY = -45;
+	const float length = std::hypot(lengthX, lengthY);
+	for (std::size_t y = 0; y < ySize; y++) {
+		for (std::size_t x = 0; x < xSize; x++) {
+			if (!grid[y][x]) continue;
+			const float dx = x - 10.0f, dy = y - 60.0f;
+			const float t =
+			    std::clamp((dx * lengthX + dy * lengthY) / (length * length), 0.0f, 1.0f);
+			const float dist = std::hypot(dx - lengthX * t, dy - lengthY * t);
+			EXPECT_LE(dist, radius + 1.5f) << x << ", " << y;
+		}
+	}
+}
+
+TEST(TerrainShapes, CoalesceKeepsLatest) {
+	std::mt19937 randGen{9};
+	std::uniform_int_distribution<std::size_t> yDist{0, 9}, xDist{0, xSize - 1}, value{0, 1};
+	for (int i = 0; i < 20; i++) {
+		std::vector<TerrainSpan> spans;
+		for (int j = 0; j < 60; j++) {
+			std::size_t x1 = xDist(randGen), x2 = xDist(randGen);
+			if (x1 > x2) std::swap(x1, x2);
+			spans.push_back(TerrainSpan{yDist(randGen), x1, x2 + 1,
+			                            static_cast<unsigned char>(value(randGen))});
+		}
+		const std::vector<TerrainSpan> coalesced = TerrainShapes::coalesce(spans);
+
+		Grid expected(ySize, std::vector<unsigned char>(xSize, 2));
+		Grid result = expected;
+		applySpans(expected, spans);
+		applySpans(result, coalesced);
+		EXPECT_EQ(result, expected);
+
+		// Every cell is written at most once
+		Grid writes(ySize, std::vector<unsigned char>(xSize));
+		for (const TerrainSpan& span : coalesced)
+			for (std::size_t x = span.x1; x < span.x2; x++) EXPECT_EQ(writes[span.y][x]++, 0);
+		EXPECT_LE(coalesced.size(), spans.size() * 2);
+	}
+}
@@ -0,0 +1,65 @@
+#include "terrain/terrainStore.h"
+
+#include <gtest/gtest.h>
+
+#include <filesystem>
+#include <random>
+
+namespace {
+constexpr std::size_t chunkSize = 20;
+
+Terrain randomTerrain(std::mt19937& randGen) {
+	std::bernoulli_distribution filled{0.4};
+	Terrain terrain{chunkSize, chunkSize};
+	for (auto& row : terrain.map)
+		for (unsigned char& cell : row) cell = filled(randGen);
+	return terrain;
+}
+
+std::string storePath() {
+	return (std::filesystem::temp_directory_path() / "terrainStore_test.pages").string();
+}
+}  // namespace
+
+TEST(TerrainStore, LoadsEvictedChunks) {
+	std::mt19937 randGen{7};
+	std::vector<Terrain> stored;
+	TerrainStore store{storePath(), chunkSize, 10, 10, 3};
+
+	// More chunks than the initial pages, so the file has to grow
+	for (std::size_t i = 0; i < 40; i++) {
+		stored.push_back(randomTerrain(randGen));
+		store.store(i % 10, i / 10, Terrain{stored.back()});
+		EXPECT_LE(store.getResidentCount(), 3);
+	}
+	EXPECT_EQ(store.getPageCount(), 37);
+	EXPECT_FALSE(store.contains(0, 4));
+
+	for (std::size_t i = 0; i < 40; i++) {
+		ASSERT_TRUE(store.contains(i % 10, i / 10));
+		EXPECT_TRUE(store.load(i % 10, i / 10).map == stored[i].map) << "Chunk " << i;
+		EXPECT_LE(store.getResidentCount(), 3);
+	}
+}
+
+TEST(TerrainStore, StoringAgainReplacesPage) {
+	std::mt19937 randGen{8};
+	TerrainStore store{storePath(), chunkSize, 4, 4, 1};
+
+	store.store(1, 2, randomTerrain(randGen));
+	store.store(0, 0, randomTerrain(randGen));  // Evicts (1, 2)
+	const Terrain latest = randomTerrain(randGen);
+	store.store(1, 2, Terrain{latest});         // Evicts (0, 0)
+	store.store(0, 0, randomTerrain(randGen));  // Evicts (1, 2) again, into the same page
+
+	EXPECT_EQ(store.getPageCount(), 2);
+	EXPECT_TRUE(store.load(1, 2).map == latest.map);
+}
+
+TEST(TerrainStore, RemovesFile) {
+	{
+		TerrainStore store{storePath(), chunkSize, 4, 4, 1};
+		EXPECT_TRUE(std::filesystem::exists(storePath()));
+	}
+	EXPECT_FALSE(std::filesystem::exists(storePath()));
+}
@@ -1,7 +1,11 @@
 #include <gtest/gtest.h>
 
+#include <chrono>
+#include <thread>
+
 #include "mockScene.h"
 #include "terrain/chunkManager.h"
+#include "terrain/terrainGenerator.h"
 
 TEST(Terrain, CollisionGeneration) {
 	const std::vector<std::vector<unsigned char>> terrainMap{
@@ -28,15 +32,314 @@ TEST(Terrain, CollisionGeneration) {
 	};
 
 	Terrain terrain{std::move(terrainMap)};
-	Game game{"", 0, 0};
+	Game game{"", 0, 0, RenderBackend::Type::NONE};
 	MockScene scene{game};
 	const std::size_t chunkSize = terrainMap.size();
 	EnemyManager enemyManager{};
 	ChunkManager manager{terrain, chunkSize, 1, SDL_Color{}, scene, enemyManager};
-	const Chunk& chunk = manager.getChunks()[0][0];
+	const Chunk& chunk = *manager.getChunk(0, 0);
 
 	constexpr std::size_t expected = 44;
 	EXPECT_TRUE(chunk.getColliderCount() == expected)
 	    << "Expected " << expected << " colliders, found " << chunk.getColliderCount();
 	game.clean();
 }
+
+TEST(Terrain, RebuildSwappedInAtFrameBoundary) {
+	std::vector<std::vector<unsigned char>> terrainMap(20, std::vector<unsigned char>(20));
+	terrainMap[5][5] = 1;
+	Terrain terrain{std::move(terrainMap)};
+	Game game{"", 0, 0, RenderBackend::Type::NONE};
+	MockScene scene{game};
+	EnemyManager enemyManager{};
+	ChunkManager manager{terrain, 20, 1, SDL_Color{}, scene, enemyManager};
+	const Chunk& chunk = *manager.getChunk(0, 0);
+	ASSERT_EQ(chunk.getColliderCount(), 4);
+
+	// Another single cell, with a collider on every side
+	manager.changeTerrain(15, 15, 1);
+	manager.update(0, Vec2{});
+	EXPECT_EQ(chunk.getTerrain().map[15][15], 1);
+	// The old colliders are used until the next frame, even if the rebuild is done already
+	EXPECT_EQ(chunk.getColliderCount(), 4);
+
+	while (chunk.isRebuilding()) manager.update(0, Vec2{});
+	EXPECT_EQ(chunk.getColliderCount(), 8);
+	game.clean();
+}
+
+TEST(Terrain, BatchedChangesAcrossChunks) {
+	Terrain terrain{40, 40};
+	Game game{"", 0, 0, RenderBackend::Type::NONE};
+	MockScene scene{game};
+	EnemyManager enemyManager{};
+	ChunkManager manager{terrain, 20, 1, SDL_Color{}, scene, enemyManager};
+
+	// One change in every chunk, and the last one is overwritten later in the same batch
+	manager.changeTerrain(5, 5, 1);
+	manager.changeTerrain(25, 6, 1);
+	manager.changeTerrain(7, 25, 1);
+	manager.changeTerrain(25, 25, 1);
+	manager.changeTerrain(25, 25, 0);
+	manager.update(0, Vec2{});
+
+	EXPECT_EQ(manager.getChunk(0, 0)->getTerrain().map[5][5], 1);
+	EXPECT_EQ(manager.getChunk(1, 0)->getTerrain().map[6][5], 1);
+	EXPECT_EQ(manager.getChunk(0, 1)->getTerrain().map[5][7], 1);
+	EXPECT_EQ(manager.getChunk(1, 1)->getTerrain().map[5][5], 0);
+	game.clean();
+}
+
+TEST(Terrain, InactiveChunksDropDerivedData) {
+	std::mt19937 randGen{5};
+	std::bernoulli_distribution filled{0.3};
+	Terrain terrain{80, 80};
+	for (auto& row : terrain.map)
+		for (unsigned char& cell : row) cell = filled(randGen);
+	Game game{"", 0, 0, RenderBackend::Type::NONE};
+	MockScene scene{game};
+	EnemyManager enemyManager{};
+	constexpr std::size_t chunkSize = 10;
+	ChunkManager manager{terrain, chunkSize, 1, SDL_Color{}, scene, enemyManager};
+
+	auto chunkCenter = [&manager](const std::size_t x, const std::size_t y) {
+		return Vec2{(x * chunkSize + chunkSize / 2) * manager.getPixelSize(),
+		            (y * chunkSize + chunkSize / 2) * manager.getPixelSize()};
+	};
+	manager.updateActiveChunks(chunkCenter(1, 1), 1);
+	EXPECT_EQ(manager.getChunk(2, 2)->getResidency(), Chunk::Residency::FULL);
+	EXPECT_NE(manager.getChunk(3, 1)->getResidency(), Chunk::Residency::COMPACT);
+	const Chunk& far = *manager.getChunk(5, 5);
+	EXPECT_EQ(far.getResidency(), Chunk::Residency::COMPACT);
+	EXPECT_EQ(far.getColliderCount(), 0);
+
+	manager.updateActiveChunks(chunkCenter(5, 5), 1);
+	EXPECT_EQ(far.getResidency(), Chunk::Residency::FULL);
+	EXPECT_EQ(far.getColliderCount(), Chunk::findSegments(far.getTerrain()).size());
+	EXPECT_EQ(manager.getChunk(1, 1)->getResidency(), Chunk::Residency::COMPACT);
+	game.clean();
+}
+
+TEST(Terrain, WallDistanceAcrossChunks) {
+	Terrain terrain{40, 40};
+	terrain.map[10][21] = 1;
+	Game game{"", 0, 0, RenderBackend::Type::NONE};
+	MockScene scene{game};
+	EnemyManager enemyManager{};
+	ChunkManager manager{terrain, 20, 1, SDL_Color{}, scene, enemyManager};
+	const float pixelSize = manager.getPixelSize();
+
+	// In chunk (0, 0), the terrain is in the chunk to the right
+	const Vec2 pos{18.5f * pixelSize, 10.5f * pixelSize};
+	manager.update(0, pos);
+	const auto wall = manager.getWallDistance(pos);
+	ASSERT_TRUE(wall.has_value());
+	EXPECT_FLOAT_EQ(wall->distance, 3 * pixelSize);
+	EXPECT_LT(wall->direction.x, -0.9f);
+
+	manager.changeTerrain(21, 10, 0);
+	manager.update(0, pos);
+	EXPECT_FLOAT_EQ(manager.getWallDistance(pos)->distance,
+	                DistanceField::maxDistance * pixelSize);
+	game.clean();
+}
+
+TEST(Terrain, FlowFieldTowardsPlayer) {
+	Terrain terrain{60, 60};
+	Game game{"", 0, 0, RenderBackend::Type::NONE};
+	MockScene scene{game};
+	EnemyManager enemyManager{};
+	ChunkManager manager{terrain, 20, 1, SDL_Color{}, scene, enemyManager};
+	const float pixelSize = manager.getPixelSize();
+
+	// Built on a worker, so it shows up a few frames later
+	const Vec2 player{30.5f * pixelSize, 30.5f * pixelSize};
+	for (int i = 0; i < 5000 && manager.getFlowField().isEmpty(); i++) {
+		manager.update(0, player);
+		std::this_thread::sleep_for(std::chrono::milliseconds{1});
+	}
+	ASSERT_FALSE(manager.getFlowField().isEmpty());
+
+	const auto direction = manager.getFlowDirection(Vec2{10.5f * pixelSize, 30.5f * pixelSize});
+	ASSERT_TRUE(direction.has_value());
+	EXPECT_FLOAT_EQ(direction->x, 1);
+	EXPECT_FALSE(manager.getFlowDirection(player).has_value());  // Already there
+	game.clean();
+}
+
+TEST(Terrain, RegionsAcrossChunks) {
+	// Wall splitting the world, in the second column of chunks
+	Terrain terrain{40, 40};
+	for (auto& row : terrain.map) row[25] = 1;
+	Game game{"", 0, 0, RenderBackend::Type::NONE};
+	MockScene scene{game};
+	EnemyManager enemyManager{};
+	ChunkManager manager{terrain, 20, 1, SDL_Color{}, scene, enemyManager};
+	auto cellPos = [&manager](const std::size_t x, const std::size_t y) {
+		return Vec2{(x + 0.5f) * manager.getPixelSize(), (y + 0.5f) * manager.getPixelSize()};
+	};
+
+	manager.update(0, cellPos(5, 5));
+	EXPECT_TRUE(manager.isConnected(cellPos(5, 5), cellPos(22, 35)));
+	EXPECT_FALSE(manager.isConnected(cellPos(5, 5), cellPos(30, 5)));
+	EXPECT_FALSE(manager.getRegion(cellPos(25, 5)).has_value());
+	EXPECT_FALSE(manager.isConnectedToPlayer(cellPos(35, 30)));
+
+	// Opening one cell of the wall joins the sides
+	manager.changeTerrain(25, 32, 0);
+	manager.update(0, cellPos(5, 5));
+	EXPECT_TRUE(manager.isConnectedToPlayer(cellPos(35, 30)));
+
+	// And closing it splits them again
+	manager.changeTerrain(25, 32, 1);
+	manager.update(0, cellPos(5, 5));
+	EXPECT_FALSE(manager.isConnectedToPlayer(cellPos(35, 30)));
+	game.clean();
+}
+
+TEST(Terrain, RecenterOriginKeepsCells) {
+	Terrain terrain{400, 40};
+	terrain.map[10][303] = 1;
+	Game game{"", 0, 0, RenderBackend::Type::NONE};
+	MockScene scene{game};
+	EnemyManager enemyManager{};
+	ChunkManager manager{terrain, 20, 1, SDL_Color{}, scene, enemyManager};
+	const float pixelSize = manager.getPixelSize();
+
+	// Close to the origin nothing moves
+	EXPECT_FLOAT_EQ(manager.recenterOrigin(Vec2{100, 100}).magnitude(), 0);
+
+	// Moved by whole chunks, to the chunk the position is in
+	const Vec2 far{300.5f * pixelSize, 10.5f * pixelSize};
+	const Vec2 offset = manager.recenterOrigin(far);
+	EXPECT_FLOAT_EQ(offset.x, -300 * pixelSize);
+	EXPECT_FLOAT_EQ(offset.y, 0);
+	EXPECT_EQ(manager.getOriginCell(), std::make_pair(std::ptrdiff_t{300}, std::ptrdiff_t{0}));
+	EXPECT_FLOAT_EQ(manager.getChunk(15, 0)->getOriginX(), 0);
+	EXPECT_FLOAT_EQ(manager.getChunk(14, 0)->getOriginX(), -20 * pixelSize);
+
+	// Shifted positions are in the same cells, also left of the origin
+	const Vec2 pos = far + offset;
+	EXPECT_EQ(manager.posToTerrainCoord(pos), std::make_pair(std::size_t{300}, std::size_t{10}));
+	EXPECT_EQ(manager.posToTerrainCoord(pos - Vec2{pixelSize, 0.0f}),
+	          std::make_pair(std::size_t{299}, std::size_t{10}));
+	EXPECT_FLOAT_EQ(manager.getWorldCenter().x, 200 * pixelSize + offset.x);
+
+	manager.update(0, pos);
+	const auto wall = manager.getWallDistance(pos);
+	ASSERT_TRUE(wall.has_value());
+	EXPECT_FLOAT_EQ(wall->distance, 3 * pixelSize);
+	EXPECT_TRUE(manager.isConnectedToPlayer(pos - Vec2{5 * pixelSize, 0.0f}));
+	game.clean();
+}
+
+namespace {
+// Counts the collisions of a circle
+class CollisionProbe : public GameObject {
+public:
+	CollisionProbe()
+	    : GameObject{std::make_unique<CircleCollider>(Collision::Circle{0.0f}, 100.0f, this)} {}
+
+	void setRadius(const float radius) {
+		static_cast<CircleCollider*>(getCollider())->circle = Collision::Circle{position, radius};
+	}
+	void onCollision(const Collision::Event& event, Scene& scene) override { collisions++; }
+
+	int collisions = 0;
+
+protected:
+	SETOBJECTTEXTURE("empty.bmp");
+};
+}  // namespace
+
+TEST(Terrain, CollidesOnRecenterFrame) {
+	Terrain terrain{400, 40};
+	terrain.map[10][303] = 1;
+	Game game{"", 0, 0, RenderBackend::Type::NONE};
+	MockScene scene{game};
+	scene.initialize();
+	EnemyManager enemyManager{};
+	ChunkManager manager{terrain, 20, 1, SDL_Color{}, scene, enemyManager};
+	const float pixelSize = manager.getPixelSize();
+
+	// Overlaps the wall, and is far enough away for the origin to move
+	CollisionProbe& probe =
+	    scene.instantiate<CollisionProbe>(Vec2{301.5f * pixelSize, 10.5f * pixelSize});
+	probe.setRadius(2 * pixelSize);
+
+	// Same order as the CombatScene
+	scene.update(0);
+	const Vec2 offset = manager.recenterOrigin(probe.getPosition());
+	ASSERT_LT(offset.x, 0);
+	scene.shiftOrigin(offset);
+	manager.update(0, probe.getPosition());
+	scene.updateCollision();
+
+	EXPECT_GT(probe.collisions, 0);
+	game.clean();
+}
+
+TEST(Terrain, UniformChunksMatchScan) {
+	constexpr std::size_t chunkSize = 40;
+	Terrain terrain{2 * chunkSize, chunkSize};
+	for (auto& row : terrain.map) std::fill(row.begin(), row.begin() + chunkSize, 1);
+	Game game{"", 0, 0, RenderBackend::Type::NONE};
+	MockScene scene{game};
+	EnemyManager enemyManager{};
+	ChunkManager manager{terrain, chunkSize, 1, SDL_Color{}, scene, enemyManager};
+
+	const Chunk& solid = *manager.getChunk(0, 0);
+	const Chunk& empty = *manager.getChunk(1, 0);
+	ASSERT_EQ(solid.getFill(), Chunk::Fill::SOLID);
+	ASSERT_EQ(empty.getFill(), Chunk::Fill::EMPTY);
+
+	// Forcing MIXED scans the cells
+	EXPECT_EQ(solid.getColliderCount(),
+	          Chunk::findSegments(solid.getTerrain(), Chunk::Fill::MIXED).size());
+	EXPECT_EQ(empty.getColliderCount(), 0);
+	EXPECT_TRUE(solid.findSpawnPositions().empty());
+	EXPECT_EQ(empty.findSpawnPositions().size(),
+	          Chunk::findSpawnCells(empty.getTerrain(), Chunk::Fill::MIXED).size());
+
+	manager.changeTerrain(5, 5, 0);
+	manager.update(0, Vec2{});
+	EXPECT_EQ(solid.getFill(), Chunk::Fill::MIXED);
+	game.clean();
+}
+
+TEST(Terrain, StreamingKeepsEditsOfUnloadedChunks) {
+	std::mt19937 randGen;
+	TerrainGenerator gen{randGen};
+	gen.edgeThickness = 0;
+	Game game{"", 0, 0, RenderBackend::Type::NONE};
+	MockScene scene{game};
+	EnemyManager enemyManager{};
+	constexpr std::size_t chunkSize = 40;
+	ChunkManager manager{gen, 3, 10, 100, 100, chunkSize, 1, SDL_Color{}, scene, enemyManager};
+	EXPECT_EQ(manager.getLoadedChunkCount(), 0);
+
+	auto chunkCenter = [&manager](const std::size_t x, const std::size_t y) {
+		return Vec2{(x * chunkSize + chunkSize / 2) * manager.getPixelSize(),
+		            (y * chunkSize + chunkSize / 2) * manager.getPixelSize()};
+	};
+	const Vec2 start = chunkCenter(50, 50);
+	manager.update(0, start);
+	// Active chunks and the ring around them
+	EXPECT_EQ(manager.getLoadedChunkCount(), 25);
+	EXPECT_EQ(manager.getLoadTimings().chunks, 25);
+
+	const Terrain untouched = manager.getChunk(51, 50)->getTerrain();
+	const unsigned char before = manager.getChunk(50, 50)->getTerrain().map[5][5];
+	manager.changeTerrain(50 * chunkSize + 5, 50 * chunkSize + 5, !before);
+	manager.update(0, start);
+
+	// Move far enough away for the chunks to be unloaded, then come back
+	manager.update(0, chunkCenter(60, 60));
+	EXPECT_EQ(manager.getChunk(50, 50), nullptr);
+	EXPECT_EQ(manager.getLoadedChunkCount(), 25);
+	manager.update(0, start);
+
+	EXPECT_EQ(manager.getChunk(50, 50)->getTerrain().map[5][5], !before);
+	EXPECT_TRUE(manager.getChunk(51, 50)->getTerrain().map == untouched.map);
+	game.clean();
+}
@@ -0,0 +1,56 @@
+#include "engine/textureAtlas.h"
+
+#include <gtest/gtest.h>
+
+namespace {
+bool overlaps(const SDL_Rect& a, const SDL_Rect& b) {
+	return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+}  // namespace
+
+TEST(TextureAtlas, PacksWithoutOverlap) {
+	// The sizes of the images in the assets folder
+	const std::vector<SDL_Point> sizes{{1, 2}, {1, 1}, {32, 32}, {197, 65}};
+	std::vector<SDL_Point> pageSizes;
+	const auto placements = TextureAtlas::pack(sizes, 4096, 1, pageSizes);
+	ASSERT_EQ(placements.size(), sizes.size());
+	ASSERT_EQ(pageSizes.size(), 1);
+
+	for (std::size_t i = 0; i < placements.size(); i++) {
+		const SDL_Rect& rect = placements[i].rect;
+		EXPECT_EQ(rect.w, sizes[i].x);
+		EXPECT_EQ(rect.h, sizes[i].y);
+		EXPECT_GE(rect.x, 0);
+		EXPECT_GE(rect.y, 0);
+		EXPECT_LE(rect.x + rect.w, pageSizes[0].x);
+		EXPECT_LE(rect.y + rect.h, pageSizes[0].y);
+		for (std::size_t j = 0; j < i; j++) {
+			// Padding keeps them a pixel apart
+			const SDL_Rect padded{rect.x - 1, rect.y - 1, rect.w + 2, rect.h + 2};
+			EXPECT_FALSE(overlaps(padded, placements[j].rect)) << i << " and " << j;
+		}
+	}
+}
+
+TEST(TextureAtlas, OpensPagesWhenFull) {
+	const std::vector<SDL_Point> sizes(5, SDL_Point{40, 40});
+	std::vector<SDL_Point> pageSizes;
+	const auto placements = TextureAtlas::pack(sizes, 64, 0, pageSizes);
+	// Only one fits on a page of 64x64
+	ASSERT_EQ(pageSizes.size(), 5);
+	for (std::size_t i = 0; i < placements.size(); i++) {
+		EXPECT_EQ(placements[i].page, i);
+		EXPECT_EQ(placements[i].rect.x, 0);
+		EXPECT_EQ(placements[i].rect.y, 0);
+	}
+}
+
+TEST(TextureAtlas, LargeImageGetsOwnPage) {
+	const std::vector<SDL_Point> sizes{{8, 8}, {100, 10}, {8, 8}};
+	std::vector<SDL_Point> pageSizes;
+	const auto placements = TextureAtlas::pack(sizes, 64, 0, pageSizes);
+	ASSERT_EQ(pageSizes.size(), 2);
+	EXPECT_EQ(placements[0].page, placements[2].page);
+	EXPECT_NE(placements[1].page, placements[0].page);
+	EXPECT_EQ(pageSizes[placements[1].page].x, 100);
+}
@@ -0,0 +1,64 @@
+#include "terrain/wallCounter.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace {
+int bruteForceCount(const CellGrid& grid, const std::size_t midX, const std::size_t midY,
+                    const int range) {
+	const long startX = std::max(0L, static_cast<long>(midX) - range);
+	const long endX = std::min(static_cast<long>(grid.xSize) - 1, static_cast<long>(midX) + range);
+	const long startY = std::max(0L, static_cast<long>(midY) - range);
+	const long endY = std::min(static_cast<long>(grid.ySize) - 1, static_cast<long>(midY) + range);
+
+	int result = 0;
+	for (long y = startY; y <= endY; y++)
+		for (long x = startX; x <= endX; x++) result += grid.at(x, y);
+	return result;
+}
+
+CellGrid randomGrid(const std::size_t xSize, const std::size_t ySize) {
+	std::mt19937 gen{42};
+	std::bernoulli_distribution dist{0.4};
+	CellGrid grid{xSize, ySize};
+	for (unsigned char& cell : grid.cells) cell = dist(gen);
+	return grid;
+}
+}  // namespace
+
+TEST(WallCounter, MatchesBruteForce) {
+	const CellGrid grid = randomGrid(37, 23);
+	const WallCounter counter{grid};
+
+	for (const int range : {0, 1, 2, 4, 15, 40}) {
+		for (std::size_t y = 0; y < grid.ySize; y++) {
+			for (std::size_t x = 0; x < grid.xSize; x++) {
+				ASSERT_EQ(counter.count(x, y, range), bruteForceCount(grid, x, y, range))
+				    << "(" << x << ", " << y << ") range " << range;
+			}
+		}
+	}
+}
+
+TEST(WallCounter, RowMatchesBruteForce) {
+	const CellGrid grid = randomGrid(70, 9);
+	const WallCounter counter{grid};
+	std::vector<int> row(grid.xSize);
+
+	for (const int range : {1, 3, 50}) {
+		for (std::size_t y = 0; y < grid.ySize; y++) {
+			// Partial rows, as the generator counts one tile at a time
+			using Span = std::pair<std::size_t, std::size_t>;
+			for (const auto [x1, x2] : {Span{0, 70}, Span{5, 64}, Span{64, 70}}) {
+				counter.countRow(y, range, x1, x2, row.data());
+				for (std::size_t x = x1; x < x2; x++)
+					ASSERT_EQ(row[x - x1], bruteForceCount(grid, x, y, range))
+					    << "(" << x << ", " << y << ") range " << range;
+			}
+		}
+	}
+}
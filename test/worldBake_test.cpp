@@ -0,0 +1,99 @@
+#include "terrain/worldBake.h"
+
+#include <gtest/gtest.h>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+
+#include "engine/threadPool.h"
+#include "mockScene.h"
+#include "terrain/chunkManager.h"
+#include "terrain/terrainGenerator.h"
+
+namespace {
+constexpr std::size_t chunkSize = 50;
+constexpr std::size_t shapeSize = 10;
+constexpr std::uint32_t seed = 99;
+const WorldBake::Area area{40, 30, 10, 5, 3, 2};
+
+std::string tempPath(const std::string& name) {
+	return (std::filesystem::temp_directory_path() / name).string();
+}
+}  // namespace
+
+TEST(WorldBake, MatchesGeneratedChunks) {
+	std::mt19937 randGen;
+	TerrainGenerator gen{randGen};
+	gen.edgeThickness = 20;
+	ThreadPool pool{2};
+
+	for (const bool compress : {false, true}) {
+		const std::string path = tempPath(compress ? "rle.bake" : "bits.bake");
+		ASSERT_TRUE(WorldBake::bake(path, gen, seed, shapeSize, chunkSize, area, compress, pool));
+
+		const std::optional<WorldBake> bake = WorldBake::open(path);
+		ASSERT_TRUE(bake.has_value());
+		EXPECT_EQ(bake->getHeader().key,
+		          WorldBake::makeKey(gen, seed, shapeSize, chunkSize, 40, 30));
+		EXPECT_FALSE(bake->contains(9, 5));
+		EXPECT_FALSE(bake->contains(13, 5));
+
+		for (std::size_t y = 5; y < 7; y++) {
+			for (std::size_t x = 10; x < 13; x++) {
+				ASSERT_TRUE(bake->contains(x, y));
+				const Terrain expected =
+				    gen.generateChunk(x, y, chunkSize, 40 * chunkSize, 30 * chunkSize, shapeSize,
+				                      seed, pool);
+				EXPECT_TRUE(bake->getTerrain(x, y).map == expected.map);
+				EXPECT_EQ(bake->getSegments(x, y).size(), Chunk::findSegments(expected).size());
+				EXPECT_EQ(bake->getSpawns(x, y).size(), Chunk::findSpawnCells(expected).size());
+			}
+		}
+		std::remove(path.c_str());
+	}
+}
+
+TEST(WorldBake, RejectsDamagedFiles) {
+	EXPECT_FALSE(WorldBake::open(tempPath("missing.bake")).has_value());
+
+	const std::string path = tempPath("damaged.bake");
+	{
+		std::ofstream out{path, std::ios::binary};
+		out << "TDSW but not really a bake";
+	}
+	EXPECT_FALSE(WorldBake::open(path).has_value());
+	std::remove(path.c_str());
+}
+
+TEST(WorldBake, ChunkManagerLoadsBakedChunks) {
+	std::mt19937 randGen;
+	TerrainGenerator gen{randGen};
+	gen.edgeThickness = 20;
+	Game game{"", 0, 0, RenderBackend::Type::NONE};
+	MockScene scene{game};
+	EnemyManager enemyManager{};
+
+	const std::string path = tempPath("manager.bake");
+	ASSERT_TRUE(WorldBake::bake(path, gen, seed, shapeSize, chunkSize, area, true,
+	                            game.getThreadPool()));
+
+	ChunkManager generated{gen, seed, shapeSize, 40, 30, chunkSize, 1, SDL_Color{}, scene,
+	                       enemyManager};
+	ChunkManager baked{gen,         seed,  shapeSize,    40, 30, chunkSize, 1,
+	                   SDL_Color{}, scene, enemyManager, WorldBake::open(path)};
+	const Vec2 pos{11 * chunkSize * baked.getPixelSize(), 6 * chunkSize * baked.getPixelSize()};
+	generated.updateActiveChunks(pos, 1);
+	baked.updateActiveChunks(pos, 1);
+
+	for (std::size_t y = 5; y < 7; y++) {
+		for (std::size_t x = 10; x < 13; x++) {
+			EXPECT_TRUE(baked.getChunk(x, y)->getTerrain().map ==
+			            generated.getChunk(x, y)->getTerrain().map);
+			EXPECT_EQ(baked.getChunk(x, y)->getColliderCount(),
+			          generated.getChunk(x, y)->getColliderCount());
+		}
+	}
+	std::remove(path.c_str());
+	game.clean();
+}